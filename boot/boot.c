@@ -0,0 +1,53 @@
+/*
+ *  boot/boot.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ *
+ * Programa de arranque: carga el sistema operativo y le cede el control
+ * con las interrupciones prohibidas.
+ *
+ *	Uso: boot/boot minikernel/kernel
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <dlfcn.h>
+
+int main(int argc, char *argv[]){
+	void *sistema;
+	int (*arranque)();
+	sigset_t prohibidas;
+
+	if (argc!=2) {
+		fprintf(stderr, "Uso: %s fichero_sistema\n", argv[0]);
+		exit(1);
+	}
+
+	if ((sistema=dlopen(argv[1], RTLD_NOW|RTLD_LOCAL))==NULL) {
+		fprintf(stderr, "boot: no se puede cargar %s: %s\n",
+			argv[1], dlerror());
+		exit(1);
+	}
+	if ((arranque=(int (*)())dlsym(sistema, "main"))==NULL) {
+		fprintf(stderr, "boot: %s no tiene punto de entrada\n",
+			argv[1]);
+		exit(1);
+	}
+
+	/* se llega al sistema con las interrupciones prohibidas */
+	sigemptyset(&prohibidas);
+	sigaddset(&prohibidas, SIGALRM);
+	sigaddset(&prohibidas, SIGIO);
+	sigaddset(&prohibidas, SIGUSR1);
+	sigprocmask(SIG_BLOCK, &prohibidas, NULL);
+
+	return arranque();
+}
@@ -0,0 +1,1026 @@
+/*
+ *  minikernel/HAL.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ *
+ * Fichero que contiene una implementacin del mdulo HAL sobre Linux.
+ * Emula el hardware usando mecanismos del sistema anfitrin:
+ *
+ *	- niveles de interrupcin: mscaras de seales
+ *	- reloj: temporizador ITIMER_REAL (SIGALRM)
+ *	- procesadores: uno por hilo; con varios, un hilo de reloj enva
+ *	  SIGALRM a todos y SIGURG hace de interrupcin entre procesadores
+ *	- terminal: hilo que lee de la entrada estndar y genera SIGIO
+ *	- interrupcin SW: SIGUSR1 pendiente hasta que baja el nivel
+ *	- llamadas al sistema: SIGUSR2 enviada por la biblioteca de usuario
+ *	- excepciones: SIGFPE, SIGSEGV y SIGBUS
+ *	- imgenes de memoria: ejecutables cargados con dlopen
+ *	- pgina de datos: memoria annima proyectada dos veces, con
+ *	  escritura para el kernel y de slo lectura para los procesos
+ *	- modo de simulacin: el reloj avanza en tiempo virtual, un tick cada
+ *	  cierto nmero de llamadas al sistema y en cada halt, y el terminal
+ *	  se alimenta de la entrada estndar, de modo que la ejecucin es
+ *	  rpida y reproducible
+ *	- contextos: cambio de pila en ensamblador en x86-64, ucontext en
+ *	  el resto de arquitecturas
+ *
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <termios.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <dlfcn.h>
+#include <sys/time.h>
+#include <sys/mman.h>
+
+#include "HAL.h"
+#include "const.h"
+#include "llamsis.h"
+
+#undef printf
+
+/* Seales usadas para emular cada vector */
+#define SENAL_RELOJ SIGALRM
+#define SENAL_TERMINAL SIGIO
+#define SENAL_SW SIGUSR1
+#define SENAL_LLAMSIS SIGUSR2	/* debe coincidir con usuario/lib/misc.c */
+#define SENAL_IPI SIGURG
+
+/* Directorio por defecto de los programas de usuario */
+#define DIR_PROGRAMAS "usuario"
+
+/* Tamao del buffer usado por printk */
+#define TAM_BUF_PRINTK 1024
+
+/* Intentos de coger el cerrojo del kernel antes de ceder el hilo */
+#define ESPERAS_CERROJO 100
+
+/* Valores por defecto del modo de simulacin */
+#define LLAMADAS_POR_TICK 10	/* llamadas al sistema por tick virtual */
+#define TICKS_SIMULACION 100000	/* ticks virtuales antes de terminar */
+
+/* Cambio de contexto en ensamblador (debe coincidir con HAL.h) */
+#if defined(__x86_64__) && !defined(CAMBIO_CONTEXTO_UCONTEXT)
+#define CAMBIO_PILA
+#endif
+
+/* Manejadores instalados para cada vector */
+static void (*manejadores[NVECTORES])();
+
+/* Mscara de seales correspondiente a cada nivel de interrupcin */
+static sigset_t mascara_nivel[NUM_NIVELES+1];
+static int mascaras_iniciadas=0;
+
+/* Estado de cada procesador */
+typedef struct {
+	long registros[NREGS];		/* banco de registros generales */
+	volatile int modo_usuario;	/* modo de ejecucin actual */
+	volatile int previo_usuario;	/* y previo a la ltima interrupcin */
+	volatile int nivel_actual;	/* para no consultar la mscara al
+					   cambiar de contexto */
+	volatile int anidamiento;	/* entradas al kernel con el cerrojo */
+	void *pila_pendiente;		/* pila que falta por liberar */
+	pthread_t hilo;
+	volatile int arrancado;
+} estado_cpu;
+
+static estado_cpu cpus[MAX_PROCESADORES];
+static int num_cpus=1;
+static __thread int id_cpu=0;
+
+/* Procesador que tiene el cerrojo del kernel o -1 */
+static volatile int propietario_cerrojo=-1;
+
+/* Funcin que ejecutan los procesadores secundarios y periodo del reloj */
+static void (*inicio_secundarios)();
+static long periodo_reloj;
+
+/* Puerto del terminal y sincronizacin con el hilo lector */
+static volatile char puerto_terminal;
+static sem_t caracter_consumido;
+static pthread_t hilo_principal;
+static pthread_t hilo_terminal;
+static pthread_t hilo_reloj;
+
+/* Estado del modo de simulacin */
+static int simulacion=0;
+static int llamadas_por_tick;
+static long llamadas_simuladas=0;
+static long ticks_simulados=0;
+static long ticks_maximos;
+static int ticks_por_segundo=1;
+
+/* Guion con la entrada del terminal en modo de simulacin */
+static char *guion=NULL;
+static size_t tam_guion=0;
+static size_t pos_guion=0;
+static int caracter_pendiente=0;
+
+/* Configuracin del terminal anfitrin antes de arrancar */
+static struct termios termios_original;
+static int termios_modificado=0;
+
+/*
+ *
+ * Funciones internas del mdulo
+ *
+ */
+
+/*
+ * Calcula la mscara de seales de cada nivel de interrupcin
+ */
+static void iniciar_mascaras(){
+	int i;
+
+	if (mascaras_iniciadas)
+		return;
+	for (i=0; i<=NUM_NIVELES; i++)
+		sigemptyset(&mascara_nivel[i]);
+	for (i=NIVEL_1; i<=NUM_NIVELES; i++)
+		sigaddset(&mascara_nivel[i], SENAL_SW);
+	for (i=NIVEL_2; i<=NUM_NIVELES; i++)
+		sigaddset(&mascara_nivel[i], SENAL_TERMINAL);
+	sigaddset(&mascara_nivel[NIVEL_3], SENAL_RELOJ);
+	mascaras_iniciadas=1;
+}
+
+/*
+ * Estado del procesador que ejecuta. Un proceso puede continuar en otro
+ * procesador tras un cambio de contexto, por lo que no se debe guardar
+ * el resultado entre medias.
+ */
+int cpu_actual() __attribute__((noinline, noipa));
+
+static estado_cpu *cpu_local(){
+	return &cpus[num_cpus>1 ? cpu_actual() : 0];
+}
+
+/*
+ * Cerrojo del kernel. Se coge al entrar en cada interrupcin y se suelta
+ * al salir; las interrupciones anidadas en el mismo procesador slo
+ * incrementan el anidamiento, que se anota antes de intentar cogerlo por
+ * si llega una interrupcin mientras se espera.
+ */
+static void coger_cerrojo(){
+	int yo, libre, intentos=0;
+
+	if (num_cpus==1)
+		return;
+	yo=cpu_actual();
+	cpus[yo].anidamiento++;
+	while (propietario_cerrojo!=yo) {
+		libre=-1;
+		if (__atomic_compare_exchange_n(&propietario_cerrojo, &libre,
+				yo, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			break;
+		if (++intentos%ESPERAS_CERROJO==0)
+			sched_yield();
+	}
+}
+
+static void soltar_cerrojo(){
+	int yo;
+
+	if (num_cpus==1)
+		return;
+	yo=cpu_actual();
+	if (--cpus[yo].anidamiento==0)
+		__atomic_compare_exchange_n(&propietario_cerrojo, &yo, -1, 0,
+			__ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+/*
+ * Suelta el cerrojo del todo devolviendo el anidamiento, que se recupera
+ * con recuperar_cerrojo
+ */
+static int dejar_cerrojo(){
+	int yo, anidamiento;
+
+	if (num_cpus==1)
+		return 0;
+	yo=cpu_actual();
+	anidamiento=cpus[yo].anidamiento;
+	cpus[yo].anidamiento=0;
+	__atomic_compare_exchange_n(&propietario_cerrojo, &yo, -1, 0,
+		__ATOMIC_RELEASE, __ATOMIC_RELAXED);
+	return anidamiento;
+}
+
+static void recuperar_cerrojo(int anidamiento){
+	if (num_cpus==1 || anidamiento==0)
+		return;
+	coger_cerrojo();
+	cpu_local()->anidamiento+=anidamiento-1;
+}
+
+/*
+ * Devuelve el nivel de interrupcin que corresponde a una mscara
+ */
+static int nivel_de_mascara(sigset_t *mascara){
+	if (sigismember(mascara, SENAL_RELOJ))
+		return NIVEL_3;
+	if (sigismember(mascara, SENAL_TERMINAL))
+		return NIVEL_2;
+	if (sigismember(mascara, SENAL_SW))
+		return NIVEL_1;
+	return 0;
+}
+
+/*
+ * Devuelve el nivel al que se ejecuta el manejador de un vector: las
+ * llamadas y las excepciones no pueden ser expulsadas por la int. SW
+ */
+static int nivel_de_vector(int vector){
+	switch (vector){
+		case INT_RELOJ: return NIVEL_3;
+		case INT_TERMINAL: return NIVEL_2;
+		default: return NIVEL_1;
+	}
+}
+
+/*
+ * Devuelve el vector asociado a una seal
+ */
+static int vector_de_senal(int senal){
+	switch (senal){
+		case SIGFPE: return EXC_ARITM;
+		case SIGSEGV:
+		case SIGBUS: return EXC_MEM;
+		case SENAL_RELOJ: return INT_RELOJ;
+		case SENAL_TERMINAL: return INT_TERMINAL;
+		case SENAL_LLAMSIS: return LLAM_SIS;
+		default: return INT_SW;
+	}
+}
+
+/*
+ * Avanza un tick el reloj virtual en modo de simulacin: genera la
+ * interrupcin de reloj y, si ya se ley el anterior, la de terminal con
+ * el siguiente carcter del guion. Las seales se envan al propio hilo,
+ * por lo que se tratan en cuanto el nivel de interrupcin lo permite.
+ */
+static void avanzar_tick_simulado(){
+	if (ticks_maximos>0 && ticks_simulados>=ticks_maximos) {
+		printk("FIN DE LA SIMULACION TRAS %ld TICKS\n", ticks_simulados);
+		exit(0);
+	}
+	ticks_simulados++;
+	pthread_kill(pthread_self(), SENAL_RELOJ);
+	if (!caracter_pendiente && pos_guion<tam_guion) {
+		puerto_terminal=guion[pos_guion++];
+		caracter_pendiente=1;
+		pthread_kill(pthread_self(), SENAL_TERMINAL);
+	}
+}
+
+/*
+ * Lee completa la entrada estndar como guion del terminal, salvo que
+ * sea un terminal interactivo
+ */
+static void leer_guion(){
+	size_t capacidad=0;
+	ssize_t n;
+
+	if (isatty(0))
+		return;
+	for (;;) {
+		if (tam_guion==capacidad) {
+			capacidad=capacidad ? 2*capacidad : 4096;
+			if ((guion=realloc(guion, capacidad))==NULL)
+				panico("no hay memoria para el guion del terminal");
+		}
+		n=read(0, guion+tam_guion, capacidad-tam_guion);
+		if (n<=0)
+			break;
+		tam_guion+=n;
+	}
+}
+
+/*
+ * Punto de entrada comn de todas las interrupciones. Guarda el modo
+ * previo, que se restaura al retornar aunque entre medias se haya
+ * producido un cambio de contexto. El nivel previo se obtiene de la
+ * mscara salvada por la seal, que es la que restaura el retorno.
+ */
+static void tratar_senal(int senal, siginfo_t *info, void *ctx){
+	int vector=vector_de_senal(senal);
+	estado_cpu *cpu=cpu_local();
+	int modo_anterior=cpu->modo_usuario;
+	int previo_anterior=cpu->previo_usuario;
+	int nivel_anterior=nivel_de_mascara(&((ucontext_t *)ctx)->uc_sigmask);
+	long *regs_usuario=NULL;
+
+	cpu->previo_usuario=cpu->modo_usuario;
+	cpu->modo_usuario=0;
+	cpu->nivel_actual=nivel_anterior;
+	if (nivel_de_vector(vector)>cpu->nivel_actual)
+		cpu->nivel_actual=nivel_de_vector(vector);
+	coger_cerrojo();
+
+	if (vector==LLAM_SIS) {
+		regs_usuario=(long *)info->si_value.sival_ptr;
+		memcpy(cpu->registros, regs_usuario, sizeof(cpu->registros));
+	}
+
+	if (manejadores[vector])
+		manejadores[vector]();
+	else
+		panico("interrupcion sin manejador");
+
+	if (simulacion && vector==LLAM_SIS &&
+	    ++llamadas_simuladas%llamadas_por_tick==0)
+		avanzar_tick_simulado();
+
+	/* puede haber continuado en otro procesador */
+	cpu=cpu_local();
+	if (regs_usuario)
+		regs_usuario[0]=cpu->registros[0];
+
+	soltar_cerrojo();
+	cpu->modo_usuario=modo_anterior;
+	cpu->previo_usuario=previo_anterior;
+	cpu->nivel_actual=nivel_anterior;
+}
+
+/*
+ * La interrupcin entre procesadores slo sirve para sacar de halt al
+ * procesador destino
+ */
+static void tratar_ipi(int senal){
+}
+
+/*
+ * Restaura la configuracin del terminal anfitrin
+ */
+static void restaurar_terminal(){
+	if (termios_modificado)
+		tcsetattr(0, TCSANOW, &termios_original);
+}
+
+/*
+ * Hilo que emula el controlador de teclado: por cada carcter ledo
+ * genera una interrupcin y espera a que se lea el puerto.
+ */
+static void *lector_terminal(void *arg){
+	sigset_t todas;
+	char car;
+
+	sigfillset(&todas);
+	pthread_sigmask(SIG_BLOCK, &todas, NULL);
+
+	while (read(0, &car, 1)==1) {
+		puerto_terminal=car;
+		pthread_kill(hilo_principal, SENAL_TERMINAL);
+		while (sem_wait(&caracter_consumido)<0);
+	}
+	return NULL;
+}
+
+/*
+ * Hilo que emula el reloj con varios procesadores: en cada tick genera
+ * una interrupcin en todos los que estn arrancados
+ */
+static void *reloj_procesadores(void *arg){
+	sigset_t todas;
+	struct timespec t;
+	int i;
+
+	sigfillset(&todas);
+	pthread_sigmask(SIG_BLOCK, &todas, NULL);
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	for (;;) {
+		t.tv_nsec+=periodo_reloj;
+		while (t.tv_nsec>=1000000000) {
+			t.tv_nsec-=1000000000;
+			t.tv_sec++;
+		}
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL)!=0);
+		for (i=0; i<num_cpus; i++)
+			if (cpus[i].arrancado)
+				pthread_kill(cpus[i].hilo, SENAL_RELOJ);
+	}
+	return NULL;
+}
+
+/*
+ * Hilo de cada procesador secundario: arranca con las interrupciones
+ * prohibidas y dentro del kernel, como el principal
+ */
+static void *hilo_procesador(void *arg){
+	estado_cpu *cpu;
+
+	id_cpu=(int)(long)arg;
+	cpu=cpu_local();
+	pthread_sigmask(SIG_SETMASK, &mascara_nivel[NIVEL_3], NULL);
+	cpu->nivel_actual=NIVEL_3;
+	cpu->hilo=pthread_self();
+	coger_cerrojo();
+	cpu->arrancado=1;
+
+	inicio_secundarios();
+	panico("procesador reactivado inesperadamente");
+	return NULL;
+}
+
+/*
+ * Funcin de arranque de un proceso: ejecuta el programa (o la funcin de
+ * un hilo, con el argumento que el kernel dej en el registro 1) en modo
+ * usuario y, si ste retorna, invoca terminar_proceso.
+ */
+static void arranque_proceso(int (*pc_inicial)()){
+	long argumento=cpu_local()->registros[1];
+	long regs_fin[NREGS]={TERMINAR_PROCESO};
+	union sigval valor;
+
+	/* el programa se ejecuta fuera del kernel con las interrupciones
+	   permitidas */
+	dejar_cerrojo();
+	fijar_nivel_int(0);
+	cpu_local()->modo_usuario=1;
+	cpu_local()->previo_usuario=1;
+
+	/* lo que devuelve queda en el registro 1 de terminar_proceso */
+	regs_fin[1]=pc_inicial(argumento);
+
+	valor.sival_ptr=regs_fin;
+	pthread_sigqueue(pthread_self(), SENAL_LLAMSIS, valor);
+	panico("proceso reactivado despues de terminar");
+}
+
+#ifdef CAMBIO_PILA
+
+/*
+ * Cambio de pila en x86-64: cambiar_pila(&pila_a_salvar, pila_a_restaurar)
+ * apila los registros que el ABI obliga a conservar en una llamada, guarda
+ * el puntero de pila, carga el del otro contexto y desapila sus registros.
+ * El resto de registros ya los ha salvado el compilador, al tratarse de
+ * una llamada a funcin. No se tocan las mscaras de seales: el nivel de
+ * interrupcin lo ajusta cambio_contexto slo cuando difiere.
+ *
+ * Un contexto nuevo retorna a inicio_proceso, que llama a la funcin
+ * que hay en r13 pasndole como argumento el valor de r12.
+ */
+void cambiar_pila(void **pila_a_salvar, void *pila_a_restaurar)
+	__attribute__((visibility("hidden")));
+void inicio_proceso(void) __attribute__((visibility("hidden")));
+
+__asm__(
+	"	.text\n"
+	"	.globl cambiar_pila\n"
+	"	.hidden cambiar_pila\n"
+	"	.type cambiar_pila, @function\n"
+	"cambiar_pila:\n"
+	"	pushq %rbp\n"
+	"	pushq %rbx\n"
+	"	pushq %r12\n"
+	"	pushq %r13\n"
+	"	pushq %r14\n"
+	"	pushq %r15\n"
+	"	movq %rsp, (%rdi)\n"
+	"	movq %rsi, %rsp\n"
+	"	popq %r15\n"
+	"	popq %r14\n"
+	"	popq %r13\n"
+	"	popq %r12\n"
+	"	popq %rbx\n"
+	"	popq %rbp\n"
+	"	ret\n"
+	"	.size cambiar_pila, .-cambiar_pila\n"
+	"	.globl inicio_proceso\n"
+	"	.hidden inicio_proceso\n"
+	"	.type inicio_proceso, @function\n"
+	"inicio_proceso:\n"
+	"	movq %r12, %rdi\n"
+	"	call *%r13\n"
+	"	ud2\n"
+	"	.size inicio_proceso, .-inicio_proceso\n"
+);
+
+/* Registros apilados por cambiar_pila, en el orden en que los desapila */
+enum { PILA_R15, PILA_R14, PILA_R13, PILA_R12, PILA_RBX, PILA_RBP,
+	PILA_RETORNO, PILA_PALABRAS };
+
+#else
+
+/*
+ * Con ucontext, makecontext slo garantiza el paso de argumentos int
+ */
+static void arranque_ucontext(unsigned int pc_alto, unsigned int pc_bajo){
+	arranque_proceso((int (*)())(((unsigned long)pc_alto<<32)|pc_bajo));
+}
+
+#endif /* CAMBIO_PILA */
+
+/*
+ *
+ * Operaciones relacionadas con los dispositivos y las interrupciones.
+ *
+ */
+
+unsigned long long int leer_reloj_CMOS(){
+	if (simulacion)
+		return ticks_simulados/ticks_por_segundo;
+	return (unsigned long long int)time(NULL);
+}
+
+void iniciar_cont_reloj(int ticks_por_seg){
+	struct itimerval t;
+
+	if (simulacion) {
+		ticks_por_segundo=ticks_por_seg;
+		return;
+	}
+
+	if (num_cpus>1) {
+		periodo_reloj=1000000000L/ticks_por_seg;
+		if (pthread_create(&hilo_reloj, NULL, reloj_procesadores, NULL)!=0)
+			panico("no se puede iniciar el reloj");
+		return;
+	}
+	t.it_interval.tv_sec=0;
+	t.it_interval.tv_usec=1000000/ticks_por_seg;
+	t.it_value=t.it_interval;
+	if (setitimer(ITIMER_REAL, &t, NULL)<0)
+		panico("no se puede iniciar el reloj");
+}
+
+void iniciar_cont_teclado(){
+	struct termios t;
+
+	if (simulacion) {
+		leer_guion();
+		return;
+	}
+
+	if (isatty(0) && tcgetattr(0, &termios_original)==0) {
+		t=termios_original;
+		t.c_lflag&=~(ICANON|ECHO);
+		t.c_cc[VMIN]=1;
+		t.c_cc[VTIME]=0;
+		if (tcsetattr(0, TCSANOW, &t)==0) {
+			termios_modificado=1;
+			atexit(restaurar_terminal);
+		}
+	}
+	sem_init(&caracter_consumido, 0, 0);
+	if (pthread_create(&hilo_terminal, NULL, lector_terminal, NULL)!=0)
+		panico("no se puede iniciar el teclado");
+}
+
+void iniciar_cont_int(){
+	struct sigaction act;
+	char *valor;
+
+	hilo_principal=pthread_self();
+	iniciar_mascaras();
+
+	/* se sigue con las interrupciones prohibidas */
+	sigprocmask(SIG_SETMASK, &mascara_nivel[NIVEL_3], NULL);
+	cpus[0].nivel_actual=NIVEL_3;
+	cpus[0].hilo=hilo_principal;
+	cpus[0].arrancado=1;
+
+	/* la simulacin slo es reproducible con un procesador */
+	if ((valor=getenv("MINIKERNEL_SIMULACION"))!=NULL) {
+		simulacion=1;
+		llamadas_por_tick=LLAMADAS_POR_TICK;
+		if ((valor=getenv("MINIKERNEL_LLAMADAS_POR_TICK"))!=NULL &&
+		    atoi(valor)>0)
+			llamadas_por_tick=atoi(valor);
+		ticks_maximos=TICKS_SIMULACION;
+		if ((valor=getenv("MINIKERNEL_TICKS_MAX"))!=NULL)
+			ticks_maximos=atol(valor);
+	}
+	else if ((valor=getenv("MINIKERNEL_PROCESADORES"))!=NULL) {
+		num_cpus=atoi(valor);
+		if (num_cpus<1)
+			num_cpus=1;
+		if (num_cpus>MAX_PROCESADORES)
+			num_cpus=MAX_PROCESADORES;
+	}
+	if (num_cpus>1) {
+		memset(&act, 0, sizeof(act));
+		act.sa_handler=tratar_ipi;
+		act.sa_flags=SA_RESTART;
+		sigaction(SENAL_IPI, &act, NULL);
+
+		/* el procesador principal arranca dentro del kernel */
+		coger_cerrojo();
+	}
+}
+
+void instal_man_int(int nvector, void (*manej)()){
+	struct sigaction act;
+	int nivel;
+
+	if (nvector<0 || nvector>=NVECTORES)
+		panico("vector de interrupcion no valido");
+	manejadores[nvector]=manej;
+	iniciar_mascaras();
+
+	nivel=nivel_de_vector(nvector);
+
+	memset(&act, 0, sizeof(act));
+	act.sa_sigaction=tratar_senal;
+	act.sa_flags=SA_SIGINFO|SA_RESTART;
+	act.sa_mask=mascara_nivel[nivel];
+
+	switch (nvector){
+		case EXC_ARITM: sigaction(SIGFPE, &act, NULL); break;
+		case EXC_MEM: sigaction(SIGSEGV, &act, NULL);
+			      sigaction(SIGBUS, &act, NULL); break;
+		case INT_RELOJ: sigaction(SENAL_RELOJ, &act, NULL); break;
+		case INT_TERMINAL: sigaction(SENAL_TERMINAL, &act, NULL); break;
+		case LLAM_SIS: sigaction(SENAL_LLAMSIS, &act, NULL); break;
+		case INT_SW: sigaction(SENAL_SW, &act, NULL); break;
+	}
+}
+
+int fijar_nivel_int(int nivel){
+	sigset_t anterior;
+
+	iniciar_mascaras();
+	sigprocmask(SIG_SETMASK, &mascara_nivel[nivel], &anterior);
+	cpu_local()->nivel_actual=nivel;
+	return nivel_de_mascara(&anterior);
+}
+
+int viene_de_modo_usuario(){
+	return cpu_local()->previo_usuario;
+}
+
+void activar_int_SW(){
+	pthread_kill(pthread_self(), SENAL_SW);
+}
+
+/*
+ *
+ * Operaciones relacionadas con los procesadores
+ *
+ */
+
+int num_procesadores(){
+	return num_cpus;
+}
+
+/* no se debe integrar en el llamante (ver cpu_local) */
+int cpu_actual(){
+	return id_cpu;
+}
+
+void arrancar_procesadores(void (*inicio)()){
+	pthread_t hilo;
+	long i;
+
+	inicio_secundarios=inicio;
+	for (i=1; i<num_cpus; i++)
+		if (pthread_create(&hilo, NULL, hilo_procesador, (void *)i)!=0)
+			panico("no se puede arrancar un procesador");
+}
+
+void despertar_procesador(int cpu){
+	if (cpu>=0 && cpu<num_cpus && cpus[cpu].arrancado)
+		pthread_kill(cpus[cpu].hilo, SENAL_IPI);
+}
+
+/*
+ *
+ * Operacin de salvaguarda y recuperacin de contexto hardware del proceso.
+ *
+ */
+#ifdef CAMBIO_PILA
+
+/*
+ * El nivel de interrupcin forma parte del contexto, pero slo se cambia
+ * la mscara si el contexto restaurado lo tena distinto. Antes de cambiar
+ * de pila se sube si hace falta y, ya en el contexto restaurado, se baja,
+ * de manera que no pueda llegar una interrupcin sobre la pila del
+ * proceso saliente estando ya p_proc_actual apuntando al entrante. El
+ * anidamiento del cerrojo del kernel tambin es parte del contexto.
+ */
+void cambio_contexto(contexto_t *contexto_a_salvar, contexto_t *contexto_a_restaurar){
+	estado_cpu *cpu=cpu_local();
+	void *pila_descartada;
+
+	/* el planificador puede volver a elegir al proceso expulsado */
+	if (contexto_a_salvar==contexto_a_restaurar)
+		return;
+
+	if (contexto_a_salvar) {
+		memcpy(contexto_a_salvar->registros, cpu->registros,
+			sizeof(cpu->registros));
+		contexto_a_salvar->nivel=cpu->nivel_actual;
+		contexto_a_salvar->anidamiento=cpu->anidamiento;
+	}
+	memcpy(cpu->registros, contexto_a_restaurar->registros,
+		sizeof(cpu->registros));
+
+	if (contexto_a_restaurar->nivel>cpu->nivel_actual)
+		fijar_nivel_int(contexto_a_restaurar->nivel);
+
+	/* sin contexto a salvar no se vuelve nunca */
+	if (!contexto_a_salvar) {
+		cambiar_pila(&pila_descartada, contexto_a_restaurar->pila);
+		return;
+	}
+	cambiar_pila(&contexto_a_salvar->pila, contexto_a_restaurar->pila);
+
+	/* de nuevo en este contexto, quizs en otro procesador */
+	cpu=cpu_local();
+	cpu->anidamiento=contexto_a_salvar->anidamiento;
+	if (cpu->nivel_actual>contexto_a_salvar->nivel)
+		fijar_nivel_int(contexto_a_salvar->nivel);
+}
+
+#else
+
+void cambio_contexto(contexto_t *contexto_a_salvar, contexto_t *contexto_a_restaurar){
+	estado_cpu *cpu=cpu_local();
+
+	if (contexto_a_salvar) {
+		memcpy(contexto_a_salvar->registros, cpu->registros,
+			sizeof(cpu->registros));
+		contexto_a_salvar->anidamiento=cpu->anidamiento;
+	}
+	memcpy(cpu->registros, contexto_a_restaurar->registros,
+		sizeof(cpu->registros));
+
+	if (!contexto_a_salvar)
+		setcontext(&contexto_a_restaurar->ctxt);
+	swapcontext(&contexto_a_salvar->ctxt, &contexto_a_restaurar->ctxt);
+
+	/* de nuevo en este contexto, quizs en otro procesador */
+	cpu_local()->anidamiento=contexto_a_salvar->anidamiento;
+}
+
+#endif /* CAMBIO_PILA */
+
+/*
+ *
+ * Operaciones relacionadas con mapa de memoria del proceso y pila
+ *
+ */
+
+/*
+ * Carga el ejecutable a partir de una copia privada, de manera que cada
+ * proceso tenga sus propias variables aunque ejecute el mismo programa.
+ * Se ejecuta en la pila del proceso que llama, que puede ser la de una
+ * corrutina, as que los buffers grandes son estticos: el kernel slo
+ * lo ejecuta en un procesador a la vez.
+ */
+void * crear_imagen(char *prog, void **dir_ini){
+	static char ruta[PATH_MAX];
+	static char buf[8192];
+	char copia[]="/tmp/minikernel_XXXXXX";
+	const char *dir, *init;
+	void *imagen;
+	int fd_orig, fd_copia, n;
+
+	/* el programa inicial se puede sustituir, como init= en Linux */
+	if (strcmp(prog, "init")==0 && (init=getenv("MINIKERNEL_INIT"))!=NULL)
+		prog=(char *)init;
+
+	if (strchr(prog, '/'))
+		snprintf(ruta, sizeof(ruta), "%s", prog);
+	else {
+		if ((dir=getenv("MINIKERNEL_USUARIO"))==NULL)
+			dir=DIR_PROGRAMAS;
+		snprintf(ruta, sizeof(ruta), "%s/%s", dir, prog);
+	}
+
+	if ((fd_orig=open(ruta, O_RDONLY))<0)
+		return NULL;
+	if ((fd_copia=mkstemp(copia))<0) {
+		close(fd_orig);
+		return NULL;
+	}
+	while ((n=read(fd_orig, buf, sizeof(buf)))>0)
+		if (write(fd_copia, buf, n)!=n) {
+			n=-1;
+			break;
+		}
+	close(fd_orig);
+	close(fd_copia);
+
+	imagen=(n<0)?NULL:dlopen(copia, RTLD_NOW|RTLD_LOCAL);
+	unlink(copia);
+	if (imagen==NULL)
+		return NULL;
+
+	if ((*dir_ini=dlsym(imagen, "main"))==NULL) {
+		dlclose(imagen);
+		return NULL;
+	}
+	return imagen;
+}
+
+void * crear_pila(int tam){
+	void *pila;
+
+	if ((pila=malloc(tam))==NULL)
+		panico("no hay memoria para la pila");
+	return pila;
+}
+
+void fijar_contexto_ini(void *mem, void *p_pila, int tam_pila,
+			void * pc_inicial, contexto_t *contexto_ini){
+#ifdef CAMBIO_PILA
+	long *pila;
+
+	memset(contexto_ini->registros, 0, sizeof(contexto_ini->registros));
+
+	/* a la vuelta de cambiar_pila la pila debe quedar alineada a 16 */
+	pila=(long *)(((unsigned long)p_pila+tam_pila)&~15UL)-2-PILA_PALABRAS;
+	memset(pila, 0, PILA_PALABRAS*sizeof(long));
+	pila[PILA_R12]=(long)pc_inicial;
+	pila[PILA_R13]=(long)arranque_proceso;
+	pila[PILA_RETORNO]=(long)inicio_proceso;
+	contexto_ini->pila=pila;
+	contexto_ini->nivel=0;
+#else
+	unsigned long pc=(unsigned long)pc_inicial;
+
+	memset(contexto_ini->registros, 0, sizeof(contexto_ini->registros));
+	getcontext(&contexto_ini->ctxt);
+	contexto_ini->ctxt.uc_stack.ss_sp=p_pila;
+	contexto_ini->ctxt.uc_stack.ss_size=tam_pila;
+	contexto_ini->ctxt.uc_link=NULL;
+	sigemptyset(&contexto_ini->ctxt.uc_sigmask);
+	makecontext(&contexto_ini->ctxt, (void (*)())arranque_ucontext, 2,
+		(unsigned int)(pc>>32), (unsigned int)(pc&0xffffffff));
+#endif
+}
+
+void liberar_imagen(void *mem){
+	dlclose(mem);
+}
+
+/*
+ * El proceso que termina libera su pila antes del ltimo cambio de
+ * contexto, que se sigue ejecutando sobre ella. Por eso se libera la
+ * pila del anterior proceso terminado en el mismo procesador y sta
+ * queda pendiente.
+ */
+void liberar_pila(void *pila){
+	estado_cpu *cpu=cpu_local();
+
+	free(cpu->pila_pendiente);
+	cpu->pila_pendiente=pila;
+}
+
+/*
+ * En modo de simulacin no se ofrece: el reloj virtual slo avanza con
+ * las llamadas al sistema, y un proceso que consultara el tiempo en la
+ * pgina sin hacerlas esperara indefinidamente.
+ */
+void *crear_pagina_datos(int tam, void **dir_usuario){
+	void *dir, *vista;
+	int fd;
+
+	if (simulacion)
+		return NULL;
+	if ((fd=memfd_create("minikernel_datos", 0))<0)
+		return NULL;
+	if (ftruncate(fd, tam)<0) {
+		close(fd);
+		return NULL;
+	}
+	dir=mmap(NULL, tam, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+	vista=mmap(NULL, tam, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (dir==MAP_FAILED || vista==MAP_FAILED) {
+		if (dir!=MAP_FAILED)
+			munmap(dir, tam);
+		if (vista!=MAP_FAILED)
+			munmap(vista, tam);
+		return NULL;
+	}
+	*dir_usuario=vista;
+	return dir;
+}
+
+/*
+ *
+ * Operaciones miscelneas
+ *
+ */
+
+long leer_registro(int nreg){
+	if (nreg<0 || nreg>=NREGS)
+		return 0;
+	return cpu_local()->registros[nreg];
+}
+
+int escribir_registro(int nreg, long valor){
+	if (nreg<0 || nreg>=NREGS)
+		return -1;
+	cpu_local()->registros[nreg]=valor;
+	return 0;
+}
+
+/*
+ * El fichero lo indica la variable de entorno MINIKERNEL_CONFIG, como si
+ * el cargador pasara al kernel sus opciones de arranque
+ */
+int leer_config_arranque(char *buffer, int tam){
+	char *fichero;
+	int fd, leidos, total=0;
+
+	if ((fichero=getenv("MINIKERNEL_CONFIG"))==NULL)
+		return -1;
+	if ((fd=open(fichero, O_RDONLY))<0)
+		return -1;
+	while (total<tam && (leidos=read(fd, buffer+total, tam-total))>0)
+		total+=leidos;
+	close(fd);
+	return total;
+}
+
+char leer_puerto(int dir_puerto){
+	char car=puerto_terminal;
+
+	if (simulacion)
+		caracter_pendiente=0;
+	else
+		sem_post(&caracter_consumido);
+	return car;
+}
+
+/*
+ * Con varios procesadores se suelta el cerrojo del kernel mientras est
+ * parado. La interrupcin entre procesadores se bloquea hasta entrar en
+ * sigsuspend para no perder un aviso que llegue entre medias. En modo de
+ * simulacin no se espera: se salta directamente al siguiente tick.
+ */
+void halt(){
+	sigset_t actual, sin_ipi;
+	int anidamiento;
+
+	if (simulacion) {
+		avanzar_tick_simulado();
+		return;
+	}
+	sigprocmask(SIG_BLOCK, NULL, &actual);
+	if (num_cpus==1) {
+		sigsuspend(&actual);
+		return;
+	}
+	sin_ipi=actual;
+	sigaddset(&sin_ipi, SENAL_IPI);
+	sigprocmask(SIG_SETMASK, &sin_ipi, NULL);
+	anidamiento=dejar_cerrojo();
+	sigsuspend(&actual);
+	sigprocmask(SIG_SETMASK, &actual, NULL);
+	recuperar_cerrojo(anidamiento);
+}
+
+void panico(char *mens){
+	printk("PANICO: %s\n", mens);
+	exit(1);
+}
+
+void apagar(){
+	exit(0);
+}
+
+void escribir_ker(char *buffer, unsigned int longi){
+	ssize_t n;
+
+	while (longi>0 && (n=write(1, buffer, longi))>0) {
+		buffer+=n;
+		longi-=n;
+	}
+}
+
+int printk(const char *formato, ...){
+	char buf[TAM_BUF_PRINTK];
+	va_list args;
+	int n;
+
+	va_start(args, formato);
+	n=vsnprintf(buf, sizeof(buf), formato, args);
+	va_end(args);
+	if (n>=(int)sizeof(buf))
+		n=sizeof(buf)-1;
+	if (n>0)
+		escribir_ker(buf, n);
+	return n;
+}
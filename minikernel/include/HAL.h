@@ -58,11 +58,27 @@ typedef struct st_contexto {
 /* Registros generales del procesador */
 #define NREGS 6
 
-/* Contexto "hardware" de un proceso */
+/* Contexto "hardware" de un proceso. En x86-64 el cambio de contexto
+   slo salva el puntero de pila, ya que los registros que se conservan
+   en una llamada quedan en la propia pila (ver HAL.c). Compilando con
+   CAMBIO_CONTEXTO_UCONTEXT se usa ucontext en cualquier arquitectura. */
+#if defined(__x86_64__) && !defined(CAMBIO_CONTEXTO_UCONTEXT)
+typedef struct {
+	void *pila;
+	int nivel;
+	int anidamiento;
+	long registros[NREGS];
+} contexto_t;
+#else
 typedef struct {
 	ucontext_t ctxt;
+	int anidamiento;
 	long registros[NREGS];
 } contexto_t;
+#endif
+
+/* Nmero mximo de procesadores emulados */
+#define MAX_PROCESADORES 8
 
 
 
@@ -90,6 +106,23 @@ int viene_de_modo_usuario(); /* Devuelve verdadero si el modo previo de
 
 void activar_int_SW(); /* activa la interrupcin SW */
 
+/*
+ *
+ * Operaciones relacionadas con los procesadores. Con varios procesadores
+ * el kernel se ejecuta en exclusin mutua: el HAL coge un cerrojo al
+ * entrar en una interrupcin y lo suelta al salir y en halt.
+ *
+ */
+
+int num_procesadores(); /* nmero de procesadores emulados */
+
+int cpu_actual(); /* procesador que est ejecutando (0, 1, ...) */
+
+/* arranca los procesadores secundarios, que ejecutan "inicio" */
+void arrancar_procesadores(void (*inicio)());
+
+void despertar_procesador(int cpu); /* interrupcin entre procesadores */
+
 /*
  *
  * Operacin de salvaguarda y recuperacin de contexto hardware del proceso.
@@ -112,7 +145,10 @@ void * crear_imagen(char *prog, void **dir_ini);
 
 void * crear_pila(int tam); /* crea la pila del proceso */
 
-/* crea el contexto inicial del proceso */
+/* crea el contexto inicial del proceso, que arranca llamando a pc_inicial
+   con el valor inicial de su registro 1 como argumento (0 salvo que el
+   kernel lo cambie en el contexto) y al volver hace terminar_proceso con
+   lo devuelto en el registro 1 */
 void fijar_contexto_ini(void *mem, void *p_pila, int tam_pila,
 			void * pc_inicial, contexto_t *contexto_ini);
 
@@ -120,6 +156,10 @@ void liberar_imagen(void *mem);		/* libera el mapa de memoria */
 
 void liberar_pila(void *pila);		/* libera la pila del proceso */
 
+/* crea una pgina con escritura para el kernel y slo lectura para los
+   procesos; devuelve la vista del kernel, o NULL si no la hay */
+void *crear_pagina_datos(int tam, void **dir_usuario);
+
 /*
  *
  * Operaciones miscelneas
@@ -131,11 +171,16 @@ long leer_registro(int nreg);
 int escribir_registro(int nreg, long valor); 
 
 char leer_puerto(int dir_puerto); /* lee un carcter del puerto especificado */
+/* copia en buffer (hasta tam bytes) el fichero de configuracin del
+   arranque, devolviendo los bytes copiados o -1 si no lo hay */
+int leer_config_arranque(char *buffer, int tam);
 
 void halt();	/* Ejecuta una instruccin HALT para parar UCP */
 
 void panico(char *mens); /* muestra mensaje y termina SO */
 
+void apagar();	/* detiene el sistema sin error */
+
 void escribir_ker(char *buffer, unsigned int longi); /* escribe en pantalla */
 
 #define printf printk /* evita uso de printf de bilioteca estndar */
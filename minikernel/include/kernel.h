@@ -25,6 +25,131 @@
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
 
+/*
+ * Constantes usadas en la implementacin de semforos y condiciones
+ */
+#define NUM_OBJ 16 /* numero total de objetos de sincronizacion */
+#define NUM_OBJ_PROC 8 /* numero maximo de objetos que puede tener
+			  abiertos un proceso */
+#define MAX_NOM_OBJ MAX_NOM_MUT /* longitud maxima de un nombre */
+
+/*
+ * Tipos de objetos de sincronizacion
+ */
+#define OBJ_LIBRE 0
+#define OBJ_SEMAFORO 1
+#define OBJ_CONDICION 2
+#define OBJ_MEMORIA 3
+#define OBJ_COLA 4
+#define OBJ_TEMPORIZADOR 5
+
+/*
+ * Constante usada en la implementacin de memoria compartida
+ */
+#define MAX_TAM_MEM (1024*1024) /* tamao maximo de un segmento */
+
+/*
+ * Constantes usadas en las caches de bloques del kernel, que sirven las
+ * zonas de segmentos y colas en clases de tamao potencia de 2
+ */
+#define TAM_MIN_BLOQUE 64 /* bloque de la primera cache */
+#define NUM_CACHES 15 /* de TAM_MIN_BLOQUE a MAX_TAM_MEM */
+#define TAM_LOSA (64*1024) /* memoria que se aade de una vez a una cache */
+#define CACHES_EN_ARENA 11 /* caches con una losa de la arena al arrancar */
+#define ARENA_CACHES (CACHES_EN_ARENA*TAM_LOSA) /* parte de la arena para
+			las losas iniciales de las caches */
+#define ALINEACION_ARENA 16 /* alineacin de cada zona de la arena */
+
+/*
+ * Constantes usadas en la implementacin de colas de mensajes
+ */
+#define MAX_MENSAJES_COLA 64 /* numero maximo de huecos de una cola */
+#define MAX_TAM_MENSAJE 256 /* tamao maximo de un mensaje */
+
+/*
+ * Constante usada en la implementacin de futex
+ */
+#define NUM_COLAS_FUTEX 16 /* numero de colas de espera de futex */
+
+/*
+ * Constantes usadas en la espera de mltiples eventos
+ */
+#define MAX_EVENTOS 8 /* numero maximo de eventos de una espera */
+#define SIN_PLAZO -1 /* espera sin tiempo limite */
+
+/*
+ * Tipos de eventos por los que puede esperar un proceso
+ */
+#define EV_TERMINAL 0		/* hay caracteres en el buffer del terminal */
+#define EV_MUTEX 1		/* el mutex est libre */
+#define EV_SEMAFORO 2		/* el semaforo tiene valor positivo */
+#define EV_COLA_RECIBIR 3	/* la cola tiene mensajes */
+#define EV_COLA_ENVIAR 4	/* la cola tiene huecos libres */
+#define EV_TEMPORIZADOR 5	/* el temporizador ha vencido */
+
+/*
+ * Constantes usadas en las llamadas asncronas
+ */
+#define MAX_ASINC 32 /* numero total de peticiones asincronas pendientes */
+#define MAX_ASINC_PROC 8 /* peticiones de un proceso pendientes o con la
+			    terminacion sin recoger */
+
+/*
+ * Tipos de peticiones asncronas
+ */
+#define ASINC_LIBRE 0
+#define ASINC_DORMIR 1		/* vence al llegar a un tick */
+#define ASINC_LEER 2		/* recibe el siguiente caracter del terminal */
+#define ASINC_LOCK 3		/* recibe el mutex al liberarse */
+
+/*
+ * Acciones de senalar_grupo sobre los procesos de un grupo
+ */
+#define GRUPO_TERMINAR 0
+#define GRUPO_SUSPENDER 1
+#define GRUPO_REANUDAR 2
+
+/*
+ * Constantes de las cargas medias, en coma fija con BITS_CARGA bits
+ * decimales como en Linux. Se recalculan cada dcima de segundo (o cada
+ * tick, si es ms largo) con decaimiento exponencial de constante 1, 5 y
+ * 15 segundos. El intervalo en ticks y los factores de decaimiento se
+ * calculan al arrancar, ya que dependen del parmetro tick.
+ */
+#define INTERVALOS_CARGA_POR_SEG 10
+#define BITS_CARGA 11
+#define UNO_CARGA (1<<BITS_CARGA)
+#define NUM_MEDIAS_CARGA 3
+
+/*
+ * Constante usada en la planificacin de tiempo real (EDF)
+ */
+#define UTILIZACION_MAX_RT 900 /* milesimas de UCP que se pueden reservar
+				  para procesos de tiempo real */
+
+/*
+ * Polticas de planificacin de los procesos que no son de tiempo real
+ */
+#define PLAN_RR 0		/* round robin: misma UCP para todos */
+#define PLAN_STRIDE 1		/* stride: UCP proporcional a los billetes */
+#define PLAN_CFS 2		/* reparto equitativo por tiempo virtual */
+
+/*
+ * Constantes usadas en la planificacin stride
+ */
+#define BILLETES_POR_DEFECTO 100
+#define MAX_BILLETES 1000
+#define ZANCADA_BASE (1<<20) /* zancada = ZANCADA_BASE / billetes */
+
+/*
+ * Constantes usadas en la planificacin CFS (en ticks)
+ */
+#define LATENCIA_CFS 20 /* periodo en que deben ejecutar todos los listos */
+#define GRANULARIDAD_CFS 2 /* rodaja minima */
+#define CREDITO_CFS (LATENCIA_CFS/2) /* credito maximo al despertar */
+#define VRUNTIME_TICK (ZANCADA_BASE/BILLETES_POR_DEFECTO) /* tiempo virtual
+				de un tick con los billetes por defecto */
+
 /*
  *
  * Definicion del tipo que corresponde con el BCP.
@@ -33,16 +158,182 @@
  */
 typedef struct BCP_t *BCPptr;
 
+/*
+ *
+ * Definicion del tipo que corresponde con la cabecera de una lista
+ * de BCPs. Este tipo se puede usar para diversas listas (procesos listos,
+ * procesos bloqueados en semforo, etc.).
+ *
+ */
+
+typedef struct{
+	BCPptr primero;
+	BCPptr ultimo;
+} lista_BCPs;
+
 /*
  * Define un mutex
  */
 typedef struct{
-    char *nombre; 	// nombre del mutex
+    char nombre[MAX_NOM_MUT+1]; // nombre del mutex ("" si est libre)
 	int tipo;		// tipo del mutex (no recursivo = 0, recursivo = 1)
 	int procesos[MAX_PROC]; // Procesos con el mutex abierto
-	int procesosBloqueados[MAX_PROC]; // Procesos bloqueados en el mutex
+	int propietario;	// Proceso que tiene el mutex bloqueado
+	int numLocks;		// Numero de locks del propietario (0 = libre)
+	lista_BCPs esperando;	// Procesos bloqueados en lock del mutex
 } mutex;
 
+/*
+ * Define un objeto con nombre (semaforo, condicion, segmento de memoria,
+ * cola de mensajes o temporizador)
+ */
+typedef struct{
+	int tipo;		// OBJ_LIBRE|OBJ_SEMAFORO|...|OBJ_TEMPORIZADOR
+	char nombre[MAX_NOM_OBJ+1]; // nombre del objeto
+	int referencias;	// Descriptores abiertos sobre el objeto
+	int valor;		// Contador del semaforo
+	lista_BCPs esperando;	// Procesos bloqueados en el objeto (recepcion en colas)
+	void *memoria;		// Zona del segmento o huecos de la cola
+	unsigned int tam;	// Tamao del segmento o de cada mensaje
+	int capacidad;		// Numero de huecos de la cola
+	int inicio;		// Hueco del mensaje mas antiguo
+	int numMensajes;	// Mensajes almacenados en la cola
+	lista_BCPs esperandoEnvio; // Procesos bloqueados enviando a la cola llena
+	int periodo;		// Periodo del temporizador en ticks
+	int vencimiento;	// Tick del proximo vencimiento del temporizador
+} objeto;
+
+/*
+ * Define un evento de la llamada esperar_eventos tal como lo pasa el
+ * usuario
+ */
+typedef struct evento {
+	int tipo;		// EV_TERMINAL|EV_MUTEX|EV_SEMAFORO|EV_COLA_*|EV_TEMPORIZADOR
+	unsigned int desc;	// Descriptor del mutex u objeto
+	int listo;		// Lo rellena el kernel: 1 si se ha producido
+} evento;
+
+/*
+ * Define una cache de bloques de un tamao: los bloques libres forman
+ * una lista enlazada a travs de su primera palabra. Cuando se agota se
+ * le aade una losa, de la arena o, si no queda, del heap, y los bloques
+ * nunca vuelven a l.
+ */
+typedef struct{
+	unsigned int tamBloque;	// Tamao de cada bloque
+	void *libres;		// Lista de bloques libres
+	int bloques;		// Bloques en todas sus losas
+	int usados;		// Bloques reservados
+	int maxUsados;		// Mximo de bloques reservados a la vez
+	int reservas;		// Reservas atendidas desde el arranque
+	int fallos;		// Reservas que no se han podido atender
+} cache_bloques;
+
+/*
+ * Define las estadsticas de memoria tal como las recibe el usuario
+ */
+typedef struct estad_cache {
+	int tam_bloque;
+	int bloques;
+	int usados;
+	int max_usados;
+	int reservas;
+	int fallos;
+} estad_cache;
+
+typedef struct estad_memoria {
+	int tam_arena;		// Tamao de la arena fijado al arrancar
+	int usado_arena;	// Parte ya repartida de la arena
+	int tam_heap;		// Memoria de losas pedida al heap
+	int num_caches;
+	estad_cache caches[NUM_CACHES];
+} estad_memoria;
+
+/*
+ * Define el control del ancho de banda de UCP de un grupo de procesos:
+ * entre todos pueden ejecutar cuota ticks de cada periodo y, al agotarla,
+ * el grupo queda estrangulado hasta que empieza el siguiente
+ */
+typedef struct cuota_grupo {
+	int cuota;		// Ticks por periodo (0 si no tiene lmite)
+	int periodo;		// Duracin del periodo en ticks
+	int inicioPeriodo;	// Tick en que empez el periodo actual
+	int consumido;		// Ticks ejecutados en el periodo actual
+	int total;		// Ticks ejecutados desde que se fij la cuota
+	int estrangulado;	// 1 si ha agotado la cuota del periodo
+	int vecesEstrangulado;	// Periodos en que ha agotado la cuota
+	int ticksEstrangulado;	// Ticks que ha pasado estrangulado
+} cuota_grupo;
+
+/*
+ * Define las estadsticas de la cuota de un grupo tal como las recibe el
+ * usuario
+ */
+typedef struct estad_cuota {
+	int cuota;
+	int periodo;
+	int consumido;
+	int total;
+	int estrangulado;
+	int veces_estrangulado;
+	int ticks_estrangulado;
+} estad_cuota;
+
+/*
+ * Define las cargas medias y la presin sobre la UCP tal como las recibe
+ * el usuario
+ */
+typedef struct estad_carga {
+	int carga[NUM_MEDIAS_CARGA];		// Medias de 1, 5 y 15 s en milsimas
+	int presion[NUM_MEDIAS_CARGA];	// Milsimas de ticks con procesos esperando UCP
+	int ejecutables;	// Procesos listos o en ejecucin ahora
+	int bloqueados;		// Procesos esperando un mutex ahora
+	int ticks_presion;	// Ticks con procesos esperando UCP
+	int ticks;		// Ticks desde el arranque
+} estad_carga;
+
+/*
+ * Define el estado de un hilo, indexado como su BCP. La entrada queda
+ * reservada hasta que se recoge su valor de terminacin o termina la
+ * ltima tarea que usa la imagen.
+ */
+typedef struct hilo {
+	void *imagen;		// Imagen que comparte (NULL si no es un hilo)
+	int terminado;		// 1 si ha terminado y su valor est sin recoger
+	int valor;		// Valor de terminacin
+} hilo;
+
+/*
+ * Define un evento por el que espera un proceso bloqueado
+ */
+typedef struct{
+	int tipo;		// Tipo del evento
+	void *objeto;		// Mutex, objeto o buffer del terminal
+} evento_esperado;
+
+/*
+ * Define una peticin asncrona pendiente: el kernel la completa por
+ * cuenta del proceso, que sigue ejecutando, y deja su terminacin en la
+ * cola del proceso
+ */
+typedef struct{
+	int tipo;		// ASINC_LIBRE|ASINC_DORMIR|ASINC_LEER|ASINC_LOCK
+	BCPptr proceso;		// Proceso que la ha hecho
+	int testigo;		// Identificador que se devuelve al proceso
+	int turno;		// Orden de llegada respecto a los bloqueados
+	int fin;		// Tick en que vence (ASINC_DORMIR)
+	mutex *m;		// Mutex esperado (ASINC_LOCK)
+} peticion_asinc;
+
+/*
+ * Define la terminacin de una peticin asncrona tal como la recibe el
+ * usuario
+ */
+typedef struct terminacion_asinc {
+	int testigo;		// El devuelto al hacer la peticin
+	int resultado;		// Lo que habra devuelto la llamada bloqueante
+} terminacion_asinc;
+
 typedef struct BCP_t {
     int id;				/* ident. del proceso */
     int estado;			/* TERMINADO|LISTO|EJECUCION|BLOQUEADO*/
@@ -51,37 +342,87 @@ typedef struct BCP_t {
 	BCPptr siguiente;		/* puntero a otro BCP */
 	void *info_mem;			/* descriptor del mapa de memoria */
 	
-	int inicio_bloqueo;		/* instante de bloqueo */
-	int secs_bloqueo;		/* numero de segundos de bloqueo */
+	int fin_bloqueo;		/* tick en que termina el bloqueo */
 	int veces_sistema;		/* numero de interr. en modo sistema */
 	int veces_usuario;		/* numero de interr. en modo usuario */
 	int numMutex;			/* numero de mutex */
 	int ticksRestantesRodaja; /* nmero de ticks restantes para terminar rodaja */
 	int bloqueadoPorLectura;/* 1 indica que esta bloqueado por lectura de caracter */
+	int caracterReservado;	/* 1 si se le despert con un caracter guardado */
 	int bloqueadoCreandoMutex;/* 1 indica que esta bloqueado por crear mutex */
-	mutex *array_mutex_proceso[NUM_MUT_PROC]; /* Array de mutex del proceso */
-	char *bloqueadoPorMutex; /* Indica el mutex que tiene bloqueado al proceso */
+	mutex **array_mutex_proceso; /* Array de numMutProc mutex del proceso */
+	mutex *bloqueadoPorMutex; /* Indica el mutex que tiene bloqueado al proceso */
+	int numLocksPendientes;	/* locks que recibe al obtener ese mutex */
+	int numObjetos;		/* numero de objetos de sincronizacion */
+	objeto *array_objetos_proceso[NUM_OBJ_PROC]; /* Array de objetos del proceso */
+	int *futexEsperado;	/* direccion de usuario por la que espera en futex */
+	int numEventos;		/* eventos por los que espera en esperar_eventos */
+	evento_esperado eventos[MAX_EVENTOS]; /* Eventos esperados */
+	int finEsperaEventos;	/* tick en que vence la espera o SIN_PLAZO */
+	int periodoRT;		/* periodo en ticks (0 si no es de tiempo real) */
+	int presupuestoRT;	/* ticks de UCP que puede usar en cada periodo */
+	int plazoRT;		/* tick en que vence el trabajo actual */
+	int consumidoRT;	/* ticks consumidos en el periodo actual */
+	int trabajoTerminado;	/* 1 si ha terminado el trabajo del periodo */
+	int fallosPlazo;	/* numero de plazos incumplidos */
+	int billetes;		/* billetes del proceso en planificacin stride */
+	int zancada;		/* avance del paso por tick de UCP */
+	long paso;		/* paso: UCP recibida ponderada por los billetes */
+	long vruntime;		/* tiempo virtual de ejecucion en CFS */
+	int enArbolCFS;		/* 1 si est en el rbol de listos de CFS */
+	BCPptr izqCFS;		/* hijos en el rbol de listos de CFS */
+	BCPptr derCFS;
+	int alturaCFS;		/* altura del subrbol (rbol AVL) */
+	int cpu;		/* procesador en cuya cola de listos se inserta */
+	int turnoEspera;	/* orden de llegada al bloquearse en lock o lectura */
+	int ultimoTestigo;	/* testigo de la ultima peticion asincrona */
+	int numAsinc;		/* peticiones asincronas pendientes o sin recoger */
+	terminacion_asinc terminaciones[MAX_ASINC_PROC]; /* cola de terminaciones */
+	int primeraTerminacion;	/* posicion de la mas antigua en la cola */
+	int numTerminaciones;	/* terminaciones sin recoger */
+	int esperandoTerminaciones; /* 1 si esta bloqueado esperandolas */
+	lista_BCPs *listaEspera; /* lista en la que esta si esta bloqueado */
+	int grupo;		/* grupo de procesos: id del que lo creo */
+	int suspendido;		/* 1 si su grupo esta suspendido */
+	int terminarPendiente;	/* 1 si debe terminar en cuanto ejecute */
+	int valorSalida;	/* valor con el que termina */
 } BCP;
 
+
 /*
- *
- * Definicion del tipo que corresponde con la cabecera de una lista
- * de BCPs. Este tipo se puede usar para diversas listas (procesos listos,
- * procesos bloqueados en semforo, etc.).
- *
+ * Estado de cada procesador: proceso actual, cola de procesos listos,
+ * si est parado esperando una interrupcin porque no hay procesos que
+ * ejecutar y el id del proceso al que va dirigida la int sw de
+ * planificacin. El proceso actual es tambin aqul sobre cuya pila
+ * se ejecuta el procesador, aunque est parado.
  */
+typedef struct {
+	BCP *proc_actual;
+	lista_BCPs listos;
+	int ocioso;
+	int idABloquear;
+} procesador;
 
-typedef struct{
-	BCP *primero;
-	BCP *ultimo;
-} lista_BCPs;
-
+/*
+ * Variable global que representa los procesadores
+ */
+procesador procesadores[MAX_PROCESADORES];
 
 /*
- * Variable global que identifica el proceso actual
+ * Variable global con el nmero de procesadores
  */
+int numProcesadores = 1;
 
-BCP * p_proc_actual=NULL;
+/*
+ * Proceso actual, cola de listos, procesador ocioso e id del proceso a
+ * bloquear son los del procesador que ejecuta, que con uno solo no hace
+ * falta consultar
+ */
+#define procesador_actual() (numProcesadores > 1 ? cpu_actual() : 0)
+#define p_proc_actual (procesadores[procesador_actual()].proc_actual)
+#define lista_listos (procesadores[procesador_actual()].listos)
+#define procesadorOcioso (procesadores[procesador_actual()].ocioso)
+#define idABloquear (procesadores[procesador_actual()].idABloquear)
 
 /*
  * Variable global que representa la tabla de procesos
@@ -89,11 +430,6 @@ BCP * p_proc_actual=NULL;
 
 BCP tabla_procs[MAX_PROC];
 
-/*
- * Variable global que representa la cola de procesos listos
- */
-lista_BCPs lista_listos= {NULL, NULL};
-
 /*
  * Variable global que representa la cola de procesos bloqueados
  */
@@ -110,10 +446,25 @@ int numTicks = 0;
 int accesoParam = 0;
 
 /*
- * Variable global que representa el id del proceso al que va
- * dirigida la int sw de planificacion
+ * Variable global con la poltica de planificacin de los procesos que
+ * no son de tiempo real
  */
-int idABloquear = 0;
+int politicaPlanificacion = PLAN_RR;
+
+/*
+ * Variable global con el tiempo virtual de stride: paso del ltimo
+ * proceso planificado
+ */
+long pasoGlobal = 0;
+
+/*
+ * Variables globales de CFS: rbol de procesos listos que no estn en
+ * ejecucin ordenado por tiempo virtual, suma de sus pesos (billetes) y
+ * tiempo virtual mnimo, que slo avanza
+ */
+BCP *arbol_cfs = NULL;
+int pesoArbolCFS = 0;
+long vruntimeMinimo = 0;
 
 /*
  *
@@ -135,25 +486,206 @@ typedef struct tiempos_ejec {
 } tiempos_ejec;
 
 /*
- * Array de mutex
+ * Pgina de datos que el kernel publica para que los procesos la lean
+ * sin hacer llamadas (debe coincidir con usuario/include/servicios.h).
+ * Se protege con un contador de secuencia: impar mientras se actualiza.
+ */
+typedef struct {
+	unsigned int secuencia;
+	int procesadores;
+	int ticks;		// numTicks
+	int id_actual;		// proceso en ejecucin (con un procesador)
+	int cambios_contexto;	// total desde el arranque
+	int politica;		// politicaPlanificacion
+	tiempos_ejec tiempos[MAX_PROC];	// indexados por id de proceso
+} pagina_datos;
+
+/*
+ * Anillo de llamadas por lotes (debe coincidir con el comienzo de
+ * anillo_llamadas en usuario/include/servicios.h). El proceso aade
+ * peticiones avanzando cola_peticiones y el kernel las consume avanzando
+ * cab_peticiones; con las terminaciones es al revs. Los ndices crecen
+ * sin lmite y se reducen mdulo TAM_ANILLO.
+ */
+#define TAM_ANILLO 64
+
+typedef struct {
+	int servicio;		// nmero de llamada (llamsis.h)
+	long param[NREGS-1];	// parmetros, en los registros 1, 2, ...
+	long dato;		// valor del proceso que se copia en la terminacin
+} peticion_lote;
+
+typedef struct {
+	long dato;
+	int resultado;
+} terminacion_lote;
+
+typedef struct {
+	unsigned int cab_peticiones;
+	unsigned int cola_peticiones;
+	peticion_lote peticiones[TAM_ANILLO];
+	unsigned int cab_terminaciones;
+	unsigned int cola_terminaciones;
+	terminacion_lote terminaciones[TAM_ANILLO];
+} anillo_llamadas;
+
+/*
+ * Pgina de datos: vista del kernel, con escritura, y direccin en la
+ * que la ven los procesos, de slo lectura. Nula si el HAL no la ofrece.
+ */
+pagina_datos *paginaDatos = NULL;
+void *paginaDatosUsuario = NULL;
+
+/*
+ * Variable global con el nmero de cambios de contexto realizados
+ */
+int cambiosContexto = 0;
+
+/*
+ * Variables globales de las cargas medias y de la presin sobre la UCP,
+ * en coma fija, y de lo acumulado en el intervalo que se est midiendo
+ */
+int intervaloCarga;		/* ticks entre reclculos de las medias */
+int expCarga[NUM_MEDIAS_CARGA];	/* UNO_CARGA*exp(-intervalo/constante) */
+int segundosCarga[NUM_MEDIAS_CARGA] = {1, 5, 15};
+int cargaMedia[NUM_MEDIAS_CARGA];
+int presionMedia[NUM_MEDIAS_CARGA];
+int sumaActivos = 0;
+int ticksPresionIntervalo = 0;
+int ticksPresion = 0;
+
+/*
+ * Parmetros del kernel. Valen lo que indica const.h salvo que se cambien
+ * en el fichero de configuracin del arranque o, los que lo admiten, con
+ * fijar_parametro. MAX_PROC sigue dimensionando la tabla de procesos:
+ * maxProcesos slo limita las entradas que se usan.
+ */
+int ticksPorSegundo = TICK;
+int ticksPorRodaja = TICKS_POR_RODAJA;
+int tamBufTerm = TAM_BUF_TERM;
+int numMut = NUM_MUT;
+int numMutProc = NUM_MUT_PROC;
+int maxProcesos = MAX_PROC;
+
+/*
+ * Define un parmetro en el registro de parmetros del kernel
+ */
+typedef struct parametro {
+	char *nombre;
+	int *valor;
+	int minimo;
+	int maximo;
+	int soloArranque;	// 1 si dimensiona estructuras creadas al arrancar
+} parametro;
+
+#define MAX_NOM_PARAM 32	/* longitud maxima del nombre de un parametro */
+#define TAM_CONFIG 4096		/* tamao maximo del fichero de configuracion */
+
+#define NUM_PARAMETROS 6
+parametro tabla_parametros[NUM_PARAMETROS] = {
+	{"tick", &ticksPorSegundo, 10, 1000, 1},
+	{"rodaja", &ticksPorRodaja, 1, 1000, 0},
+	{"buffer_terminal", &tamBufTerm, 1, 4096, 1},
+	{"mutex", &numMut, 1, 1024, 1},
+	{"mutex_proceso", &numMutProc, 1, 64, 1},
+	{"procesos", &maxProcesos, 1, MAX_PROC, 0}
+};
+
+/*
+ * Array de mutex, de numMut elementos, y descriptores de mutex de todos
+ * los procesos, numMutProc por proceso. Se reservan al arrancar.
  */
-mutex array_mutex[NUM_MUT];
+mutex *array_mutex;
+mutex **descriptoresMutex;
 
 /*
  * Variable global que indica el nmero de mutex existentes
  */
 int mutexExistentes = 0;
 
+/*
+ * Array de objetos de sincronizacion (semaforos y condiciones)
+ */
+objeto array_objetos[NUM_OBJ];
+
+/*
+ * Caches de bloques y arena, reservada al arrancar y repartida sin
+ * liberarse nunca, de la que salen las tablas que dimensionan los
+ * parmetros y las primeras losas de las caches
+ */
+cache_bloques caches[NUM_CACHES];
+char *arena = NULL;
+int tamArena = 0;
+int usadoArena = 0;
+int tamHeapCaches = 0;
+
+/*
+ * Colas de procesos bloqueados en futex, indexadas por la direccion
+ */
+lista_BCPs colas_futex[NUM_COLAS_FUTEX];
+
+/*
+ * Variable global que representa la cola de procesos esperando eventos
+ */
+lista_BCPs lista_esperando_eventos = {NULL, NULL};
+
+/*
+ * Array de peticiones asncronas pendientes
+ */
+peticion_asinc array_asinc[MAX_ASINC];
+
+/*
+ * Variable global que representa la cola de procesos suspendidos con su
+ * grupo que estaran listos para ejecutar
+ */
+lista_BCPs lista_suspendidos = {NULL, NULL};
+
+/*
+ * Variable global que representa la cola de procesos de grupos que han
+ * agotado su cuota de UCP y que estaran listos para ejecutar
+ */
+lista_BCPs lista_estrangulados = {NULL, NULL};
+
+/*
+ * Hilos, indexados por el id de su BCP, y cola de las tareas que esperan
+ * a que termine alguno
+ */
+hilo tabla_hilos[MAX_PROC];
+lista_BCPs lista_esperando_hilos = {NULL, NULL};
+
+/*
+ * Cuotas de UCP de los grupos, indexadas por el id del grupo
+ */
+cuota_grupo cuotas_grupo[MAX_PROC];
+
+/*
+ * Variable global que representa la cola de procesos esperando
+ * terminaciones de peticiones asncronas
+ */
+lista_BCPs lista_esperando_terminaciones = {NULL, NULL};
+
+/*
+ * Variable global con el ltimo turno asignado a una espera de lock o
+ * lectura, sncrona o asncrona, para atenderlas por orden de llegada
+ */
+int ultimoTurno = 0;
+
 /*
  * Buffer de caracteres procesados del terminal
  */
-char bufferCaracteres[TAM_BUF_TERM];
+char *bufferCaracteres;
 
 /*
  * Variable global que indica el nmero de caracteres en el buffer
  */
 int caracteresEnBuffer = 0;
 
+/*
+ * Caracteres del buffer guardados para lectores ya despertados que an no
+ * los han recogido
+ */
+int caracteresReservados = 0;
+
 /*
  * Prototipos de las rutinas que realizan cada llamada al sistema
  */
@@ -171,6 +703,55 @@ int sis_lock();
 int sis_unlock();
 int sis_cerrar_mutex();
 int sis_leer_caracter();
+int sis_crear_semaforo();
+int sis_abrir_semaforo();
+int sis_esperar_semaforo();
+int sis_intentar_semaforo();
+int sis_senalar_semaforo();
+int sis_cerrar_semaforo();
+int sis_crear_condicion();
+int sis_abrir_condicion();
+int sis_esperar_condicion();
+int sis_senalar_condicion();
+int sis_difundir_condicion();
+int sis_cerrar_condicion();
+int sis_futex_esperar();
+int sis_futex_despertar();
+int sis_crear_memoria();
+int sis_asociar_memoria();
+int sis_desasociar_memoria();
+int sis_crear_cola();
+int sis_abrir_cola();
+int sis_enviar_cola();
+int sis_recibir_cola();
+int sis_cerrar_cola();
+int sis_esperar_eventos();
+int sis_dormir_ticks();
+int sis_dormir_hasta();
+int sis_crear_temporizador();
+int sis_abrir_temporizador();
+int sis_esperar_temporizador();
+int sis_cerrar_temporizador();
+int sis_fijar_tiempo_real();
+int sis_esperar_periodo();
+int sis_fijar_planificacion();
+int sis_fijar_billetes();
+int sis_obtener_pagina_datos();
+int sis_procesar_lote();
+int sis_dormir_asinc();
+int sis_leer_caracter_asinc();
+int sis_lock_asinc();
+int sis_esperar_terminaciones();
+int sis_obtener_estad_memoria();
+int sis_crear_grupo();
+int sis_senalar_grupo();
+int sis_fijar_cuota_grupo();
+int sis_obtener_estad_cuota();
+int sis_obtener_estad_carga();
+int sis_leer_parametro();
+int sis_fijar_parametro();
+int sis_crear_hilo();
+int sis_esperar_hilo();
 
 /*
  * Variable global que contiene las rutinas que realizan cada llamada
@@ -187,7 +768,56 @@ servicio tabla_servicios[NSERVICIOS]={
 					{sis_lock},
 					{sis_unlock},
 					{sis_cerrar_mutex},
-					{sis_leer_caracter}
+					{sis_leer_caracter},
+					{sis_crear_semaforo},
+					{sis_abrir_semaforo},
+					{sis_esperar_semaforo},
+					{sis_intentar_semaforo},
+					{sis_senalar_semaforo},
+					{sis_cerrar_semaforo},
+					{sis_crear_condicion},
+					{sis_abrir_condicion},
+					{sis_esperar_condicion},
+					{sis_senalar_condicion},
+					{sis_difundir_condicion},
+					{sis_cerrar_condicion},
+					{sis_futex_esperar},
+					{sis_futex_despertar},
+					{sis_crear_memoria},
+					{sis_asociar_memoria},
+					{sis_desasociar_memoria},
+					{sis_crear_cola},
+					{sis_abrir_cola},
+					{sis_enviar_cola},
+					{sis_recibir_cola},
+					{sis_cerrar_cola},
+					{sis_esperar_eventos},
+					{sis_dormir_ticks},
+					{sis_dormir_hasta},
+					{sis_crear_temporizador},
+					{sis_abrir_temporizador},
+					{sis_esperar_temporizador},
+					{sis_cerrar_temporizador},
+					{sis_fijar_tiempo_real},
+					{sis_esperar_periodo},
+					{sis_fijar_planificacion},
+					{sis_fijar_billetes},
+					{sis_obtener_pagina_datos},
+					{sis_procesar_lote},
+					{sis_dormir_asinc},
+					{sis_leer_caracter_asinc},
+					{sis_lock_asinc},
+					{sis_esperar_terminaciones},
+					{sis_obtener_estad_memoria},
+					{sis_crear_grupo},
+					{sis_senalar_grupo},
+					{sis_fijar_cuota_grupo},
+					{sis_obtener_estad_cuota},
+					{sis_obtener_estad_carga},
+					{sis_leer_parametro},
+					{sis_fijar_parametro},
+					{sis_crear_hilo},
+					{sis_esperar_hilo}
 				};
 
 #endif /* _KERNEL_H */
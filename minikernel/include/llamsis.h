@@ -19,7 +19,7 @@
 #define _LLAMSIS_H
 
 /* Numero de llamadas disponibles */
-#define NSERVICIOS 12
+#define NSERVICIOS 61
 
 #define CREAR_PROCESO 0
 #define TERMINAR_PROCESO 1
@@ -34,6 +34,55 @@
 #define UNLOCK 9
 #define CERRAR_MUTEX 10
 #define LEER_CARACTER 11
+#define CREAR_SEMAFORO 12
+#define ABRIR_SEMAFORO 13
+#define ESPERAR_SEMAFORO 14
+#define INTENTAR_SEMAFORO 15
+#define SENALAR_SEMAFORO 16
+#define CERRAR_SEMAFORO 17
+#define CREAR_CONDICION 18
+#define ABRIR_CONDICION 19
+#define ESPERAR_CONDICION 20
+#define SENALAR_CONDICION 21
+#define DIFUNDIR_CONDICION 22
+#define CERRAR_CONDICION 23
+#define FUTEX_ESPERAR 24
+#define FUTEX_DESPERTAR 25
+#define CREAR_MEMORIA 26
+#define ASOCIAR_MEMORIA 27
+#define DESASOCIAR_MEMORIA 28
+#define CREAR_COLA 29
+#define ABRIR_COLA 30
+#define ENVIAR_COLA 31
+#define RECIBIR_COLA 32
+#define CERRAR_COLA 33
+#define ESPERAR_EVENTOS 34
+#define DORMIR_TICKS 35
+#define DORMIR_HASTA 36
+#define CREAR_TEMPORIZADOR 37
+#define ABRIR_TEMPORIZADOR 38
+#define ESPERAR_TEMPORIZADOR 39
+#define CERRAR_TEMPORIZADOR 40
+#define FIJAR_TIEMPO_REAL 41
+#define ESPERAR_PERIODO 42
+#define FIJAR_PLANIFICACION 43
+#define FIJAR_BILLETES 44
+#define OBTENER_PAGINA_DATOS 45
+#define PROCESAR_LOTE 46
+#define DORMIR_ASINC 47
+#define LEER_CARACTER_ASINC 48
+#define LOCK_ASINC 49
+#define ESPERAR_TERMINACIONES 50
+#define OBTENER_ESTAD_MEMORIA 51
+#define CREAR_GRUPO 52
+#define SENALAR_GRUPO 53
+#define FIJAR_CUOTA_GRUPO 54
+#define OBTENER_ESTAD_CUOTA 55
+#define OBTENER_ESTAD_CARGA 56
+#define LEER_PARAMETRO 57
+#define FIJAR_PARAMETRO 58
+#define CREAR_HILO 59
+#define ESPERAR_HILO 60
 
 #endif /* _LLAMSIS_H */
 
@@ -13,6 +13,8 @@
  *
  */
 #include <string.h>
+#include <stdlib.h>
+#include <limits.h>
 #include "kernel.h"	/* Contiene defs. usadas por este modulo */
 
 /*
@@ -38,16 +40,29 @@ static void iniciar_tabla_proc(){
 static int buscar_BCP_libre(){
 	int i;
 
-	for (i=0; i<MAX_PROC; i++)
-		if (tabla_procs[i].estado==NO_USADA)
+	for (i=0; i<maxProcesos; i++)
+		if (tabla_procs[i].estado==NO_USADA &&
+				tabla_hilos[i].imagen==NULL)
 			return i;
 	return -1;
 }
 
+/*
+ * Indica si queda algn proceso en el sistema
+ */
+static int quedan_procesos(){
+	int i;
+
+	for (i=0; i<MAX_PROC; i++)
+		if (tabla_procs[i].estado!=NO_USADA)
+			return 1;
+	return 0;
+}
+
 /*
  *
  * Funciones que facilitan el manejo de las listas de BCPs
- *	insertar_ultimo eliminar_primero eliminar_elem
+ *	insertar_ultimo insertar_primero eliminar_primero eliminar_elem
  *
  * NOTA: PRIMERO SE DEBE LLAMAR A eliminar Y LUEGO A insertar
  */
@@ -64,6 +79,16 @@ static void insertar_ultimo(lista_BCPs *lista, BCP * proc){
 	proc->siguiente=NULL;
 }
 
+/*
+ * Inserta un BCP al principio de la lista.
+ */
+static void insertar_primero(lista_BCPs *lista, BCP * proc){
+	if (lista->primero==NULL)
+		lista->ultimo= proc;
+	proc->siguiente=lista->primero;
+	lista->primero= proc;
+}
+
 /*
  * Elimina el primer BCP de la lista.
  */
@@ -95,751 +120,3941 @@ static void eliminar_elem(lista_BCPs *lista, BCP * proc){
 
 /*
  *
- * Funciones relacionadas con la planificacion
- *	espera_int planificador
+ * Funciones del rbol de procesos listos de CFS: rbol AVL ordenado por
+ * tiempo virtual cuyos nodos son los propios BCPs
+ *	encolar_cfs desencolar_cfs minimo_cfs
+ *
  */
 
+static int altura_cfs(BCP *n){
+	return (n != NULL) ? n->alturaCFS : 0;
+}
+
 /*
- * Espera a que se produzca una interrupcion
+ * Orden del rbol: tiempo virtual y, a igualdad, identificador
  */
-static void espera_int(){
-	int nivel;
+static int antes_cfs(BCP *a, BCP *b){
+	return a->vruntime < b->vruntime ||
+		(a->vruntime == b->vruntime && a->id < b->id);
+}
 
-	//printk("-> NO HAY LISTOS. ESPERA INT\n");
+static void actualizar_altura_cfs(BCP *n){
+	int hi = altura_cfs(n->izqCFS);
+	int hd = altura_cfs(n->derCFS);
 
-	/* Baja al mnimo el nivel de interrupcin mientras espera */
-	nivel=fijar_nivel_int(NIVEL_1);
-	halt();
-	fijar_nivel_int(nivel);
+	n->alturaCFS = 1 + ((hi > hd) ? hi : hd);
 }
 
-/*
- * Funcin de planificacion que implementa un algoritmo FIFO.
- */
-static BCP * planificador(){
-	while (lista_listos.primero==NULL)
-		espera_int();		/* No hay nada que hacer */
+static BCP * rotar_der_cfs(BCP *n){
+	BCP *i = n->izqCFS;
 
-	// Asigna rodaja al proceso
-	BCP *proceso = lista_listos.primero;
-	proceso->ticksRestantesRodaja = TICKS_POR_RODAJA;
+	n->izqCFS = i->derCFS;
+	i->derCFS = n;
+	actualizar_altura_cfs(n);
+	actualizar_altura_cfs(i);
+	return i;
+}
 
-	return lista_listos.primero;
+static BCP * rotar_izq_cfs(BCP *n){
+	BCP *d = n->derCFS;
+
+	n->derCFS = d->izqCFS;
+	d->izqCFS = n;
+	actualizar_altura_cfs(n);
+	actualizar_altura_cfs(d);
+	return d;
 }
 
 /*
- *
- * Funcion auxiliar que termina proceso actual liberando sus recursos.
- * Usada por llamada terminar_proceso y por rutinas que tratan excepciones
- *
+ * Restablece el equilibrio de un nodo cuyos subrboles difieren en
+ * altura en 2 como mucho
  */
-static void liberar_proceso(){
-	BCP * p_proc_anterior;
+static BCP * equilibrar_cfs(BCP *n){
+	int fe;
+
+	actualizar_altura_cfs(n);
+	fe = altura_cfs(n->izqCFS) - altura_cfs(n->derCFS);
+	if(fe > 1){
+		if(altura_cfs(n->izqCFS->izqCFS) < altura_cfs(n->izqCFS->derCFS))
+			n->izqCFS = rotar_izq_cfs(n->izqCFS);
+		return rotar_der_cfs(n);
+	}
+	if(fe < -1){
+		if(altura_cfs(n->derCFS->derCFS) < altura_cfs(n->derCFS->izqCFS))
+			n->derCFS = rotar_der_cfs(n->derCFS);
+		return rotar_izq_cfs(n);
+	}
+	return n;
+}
 
- 	// Elimina mutex abierto de lista global
-	int i;
-	for (i = 0; i < NUM_MUT_PROC; i++){
-		int j;
-		for(j = 0; j < NUM_MUT; j++){
-			
-			if (p_proc_actual->array_mutex_proceso[i] != NULL &&
-					array_mutex[j].nombre != NULL &&
-					strcmp(array_mutex[j].nombre, p_proc_actual->array_mutex_proceso[i]->nombre) == 0){
-				
-				array_mutex[j].procesos[p_proc_actual->id] = 0;
-				int cerrarMutex = 1;
-				int k;
-
-				for (k = 0; k < MAX_PROC && cerrarMutex == 1; k++){
-					if(array_mutex[j].procesos[k] == 1){
-						cerrarMutex = 0;
-					}
-				}
-
-				if(cerrarMutex == 1){			
-					// Eliminar el mutex global
-					mutexExistentes--;
-					array_mutex[j].nombre = NULL;
-
-					// Desbloquea procesos esperando para crear mutex
-
-					BCP *procesoADesbloquear = lista_bloqueados.primero;
-					BCP *procesoSiguiente = NULL;
-					if(procesoADesbloquear != NULL){
-						procesoSiguiente = procesoADesbloquear->siguiente;
-					}
-
-					while(procesoADesbloquear != NULL){
-
-						if(procesoADesbloquear->bloqueadoCreandoMutex == 1){
-							procesoADesbloquear->estado = LISTO;
-							procesoADesbloquear->bloqueadoCreandoMutex = 0;
-							int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-							eliminar_elem(&lista_bloqueados, procesoADesbloquear);
-							insertar_ultimo(&lista_listos, procesoADesbloquear);
-							fijar_nivel_int(nivel_interrupciones);
-						}
-						procesoADesbloquear = procesoSiguiente;
-						if(procesoADesbloquear != NULL){
-							procesoSiguiente = procesoADesbloquear->siguiente;
-						}
-					}
-				}
-				break;
-			}
-		}
+static BCP * insertar_arbol_cfs(BCP *raiz, BCP *proc){
+	if(raiz == NULL){
+		proc->izqCFS = NULL;
+		proc->derCFS = NULL;
+		proc->alturaCFS = 1;
+		return proc;
 	}
+	if(antes_cfs(proc, raiz))
+		raiz->izqCFS = insertar_arbol_cfs(raiz->izqCFS, proc);
+	else
+		raiz->derCFS = insertar_arbol_cfs(raiz->derCFS, proc);
+	return equilibrar_cfs(raiz);
+}
 
-	liberar_imagen(p_proc_actual->info_mem); /* liberar mapa */
+static BCP * extraer_minimo_arbol_cfs(BCP *raiz, BCP **minimo){
+	if(raiz->izqCFS == NULL){
+		*minimo = raiz;
+		return raiz->derCFS;
+	}
+	raiz->izqCFS = extraer_minimo_arbol_cfs(raiz->izqCFS, minimo);
+	return equilibrar_cfs(raiz);
+}
 
-	p_proc_actual->estado=TERMINADO;
+static BCP * eliminar_arbol_cfs(BCP *raiz, BCP *proc){
+	BCP *sucesor;
+
+	if(raiz == NULL)
+		return NULL;
+	if(raiz == proc){
+		if(raiz->izqCFS == NULL)
+			return raiz->derCFS;
+		if(raiz->derCFS == NULL)
+			return raiz->izqCFS;
+		// Lo sustituye el menor de su subrbol derecho
+		raiz->derCFS = extraer_minimo_arbol_cfs(raiz->derCFS, &sucesor);
+		sucesor->izqCFS = raiz->izqCFS;
+		sucesor->derCFS = raiz->derCFS;
+		return equilibrar_cfs(sucesor);
+	}
+	if(antes_cfs(proc, raiz))
+		raiz->izqCFS = eliminar_arbol_cfs(raiz->izqCFS, proc);
+	else
+		raiz->derCFS = eliminar_arbol_cfs(raiz->derCFS, proc);
+	return equilibrar_cfs(raiz);
+}
 
-	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-	eliminar_primero(&lista_listos); /* proc. fuera de listos */
-	fijar_nivel_int(nivel_interrupciones);
+/*
+ * Inserta un proceso listo en el rbol. Su tiempo virtual no puede
+ * cambiar mientras est en l.
+ */
+static void encolar_cfs(BCP *proc){
+	arbol_cfs = insertar_arbol_cfs(arbol_cfs, proc);
+	proc->enArbolCFS = 1;
+	pesoArbolCFS += proc->billetes;
+}
 
-	/* Realizar cambio de contexto */
-	p_proc_anterior=p_proc_actual;
-	p_proc_actual=planificador();
+static void desencolar_cfs(BCP *proc){
+	arbol_cfs = eliminar_arbol_cfs(arbol_cfs, proc);
+	proc->enArbolCFS = 0;
+	pesoArbolCFS -= proc->billetes;
+}
 
-	printk("-> C.CONTEXTO POR FIN: de %d a %d\n",
-			p_proc_anterior->id, p_proc_actual->id);
+/*
+ * Devuelve el proceso del rbol con menor tiempo virtual
+ */
+static BCP * minimo_cfs(){
+	BCP *n = arbol_cfs;
 
-	liberar_pila(p_proc_anterior->pila);
-	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
-        return; /* no debera llegar aqui */
+	if(n != NULL){
+		while(n->izqCFS != NULL)
+			n = n->izqCFS;
+	}
+	return n;
 }
 
 /*
  *
- * Funciones relacionadas con el tratamiento de interrupciones
- *	excepciones: exc_arit exc_mem
- *	interrupciones de reloj: int_reloj
- *	interrupciones del terminal: int_terminal
- *	llamadas al sistemas: llam_sis
- *	interrupciones SW: int_sw
- *
+ * Funciones relacionadas con la planificacion
+ *	espera_int insertar_listo elegir_proceso planificador
+ *	renovar_trabajos_rt
  */
 
 /*
- * Tratamiento de excepciones aritmeticas
+ * Espera a que se produzca una interrupcion
  */
-static void exc_arit(){
-
-	if (!viene_de_modo_usuario())
-		panico("excepcion aritmetica cuando estaba dentro del kernel");
-
+static void espera_int(){
+	int nivel;
 
-	printk("-> EXCEPCION ARITMETICA EN PROC %d\n", p_proc_actual->id);
-	liberar_proceso();
+	//printk("-> NO HAY LISTOS. ESPERA INT\n");
 
-        return; /* no debera llegar aqui */
+	/* Baja al mnimo el nivel de interrupcin mientras espera */
+	procesadorOcioso = 1;
+	nivel=fijar_nivel_int(NIVEL_1);
+	halt();
+	fijar_nivel_int(nivel);
+	procesadorOcioso = 0;
 }
 
 /*
- * Tratamiento de excepciones en el acceso a memoria
+ * Con varios procesadores, avisa de que hay un proceso listo en la cola
+ * de "cpu": si ese procesador est parado se le despierta y si no se
+ * despierta a otro parado para que se lo robe.
  */
-static void exc_mem(){
+static void avisar_procesador(int cpu){
+	int i;
 
-	if(accesoParam == 0){
-		if (!viene_de_modo_usuario()){
-			panico("excepcion de memoria cuando estaba dentro del kernel");
+	if(procesadores[cpu].ocioso){
+		if(cpu != procesador_actual()){
+			despertar_procesador(cpu);
+		}
+		return;
+	}
+	for (i = 0; i < numProcesadores; i++){
+		if(i != procesador_actual() && procesadores[i].ocioso){
+			despertar_procesador(i);
+			return;
 		}
 	}
-
-	printk("-> EXCEPCION DE MEMORIA EN PROC %d\n", p_proc_actual->id);
-	liberar_proceso();
-
-        return; /* no debera llegar aqui */
 }
 
 /*
- * Tratamiento de interrupciones de terminal
+ * Inserta un proceso en la cola de listos del procesador que lo ejecut
+ * por ltima vez. En round robin lo pone al final. En stride la cola se
+ * mantiene ordenada por paso, de manera que el primero es el que menos
+ * UCP ha recibido en proporcin a sus billetes; el proceso en ejecucin
+ * no pierde la cabeza de la cola. En CFS se inserta adems en el rbol
+ * ordenado por tiempo virtual. Stride y CFS slo se usan con un
+ * procesador.
  */
-static void int_terminal(){
-	char car;
-	car = leer_puerto(DIR_TERMINAL);
-	printk("-> TRATANDO INT. DE TERMINAL %c\n", car);
+static void insertar_listo(BCP *proc){
+	lista_BCPs *listos = &(procesadores[proc->cpu].listos);
+	BCP *anterior = NULL;
+	BCP *paux = listos->primero;
+
+	// Un proceso suspendido con su grupo espera a que se reanude
+	if(proc->suspendido){
+		proc->estado = BLOQUEADO;
+		proc->listaEspera = &lista_suspendidos;
+		insertar_ultimo(&lista_suspendidos, proc);
+		return;
+	}
 
-	// si el buffer no est lleno introduce el caracter nuevo
-	if(caracteresEnBuffer < TAM_BUF_TERM){
-		bufferCaracteres[caracteresEnBuffer] = car;
-		caracteresEnBuffer++;		
+	// Si su grupo ha agotado la cuota de UCP espera al siguiente periodo
+	if(cuotas_grupo[proc->grupo].estrangulado){
+		proc->estado = BLOQUEADO;
+		proc->listaEspera = &lista_estrangulados;
+		insertar_ultimo(&lista_estrangulados, proc);
+		return;
+	}
 
-		// desbloquea primer proceso bloqueado por lectura
-		BCP *proceso_bloqueado = lista_bloqueados.primero;
-	
-		int desbloqueado = 0;
-		if (proceso_bloqueado != NULL){
-			if(proceso_bloqueado->bloqueadoPorLectura == 1){
-				// Desbloquear proceso
-				desbloqueado = 1;
-				proceso_bloqueado->estado = LISTO;
-				proceso_bloqueado->bloqueadoPorLectura = 0;
-				int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-				eliminar_elem(&lista_bloqueados, proceso_bloqueado);
-				insertar_ultimo(&lista_listos, proceso_bloqueado);
-				fijar_nivel_int(nivel_interrupciones);
-			}
+	if(politicaPlanificacion == PLAN_RR){
+		insertar_ultimo(listos, proc);
+		if(numProcesadores > 1){
+			avisar_procesador(proc->cpu);
 		}
-		
-		while(desbloqueado != 1 && proceso_bloqueado != lista_bloqueados.ultimo){
-			proceso_bloqueado = proceso_bloqueado->siguiente;
-			if(proceso_bloqueado->bloqueadoPorLectura == 1){
-				// Desbloquear proceso
-				desbloqueado = 1;
-				proceso_bloqueado->estado = LISTO;
-				proceso_bloqueado->bloqueadoPorLectura = 0;
-				int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-				eliminar_elem(&lista_bloqueados, proceso_bloqueado);
-				insertar_ultimo(&lista_listos, proceso_bloqueado);
-				fijar_nivel_int(nivel_interrupciones);
+		return;
+	}
+
+	if(politicaPlanificacion == PLAN_CFS){
+		if(proc->periodoRT == 0){
+			// Al despertar conserva como mucho CREDITO_CFS ticks de
+			// ventaja sobre los dems
+			if(proc->vruntime < vruntimeMinimo - CREDITO_CFS * VRUNTIME_TICK){
+				proc->vruntime = vruntimeMinimo - CREDITO_CFS * VRUNTIME_TICK;
 			}
+			encolar_cfs(proc);
 		}
+		insertar_ultimo(listos, proc);
+		return;
 	}
-    return;
-}
 
-/*
- * Tratamiento de interrupciones de reloj
- */
-static void int_reloj(){
+	// Un proceso que vuelve de un bloqueo no acumula crdito
+	if(proc->paso < pasoGlobal){
+		proc->paso = pasoGlobal;
+	}
 
-	//printk("-> TRATANDO INT. DE RELOJ\n");
+	if(paux != NULL && paux == procesadores[proc->cpu].proc_actual){
+		anterior = paux;
+		paux = paux->siguiente;
+	}
+	while(paux != NULL && paux->paso <= proc->paso){
+		anterior = paux;
+		paux = paux->siguiente;
+	}
 
-	BCP *proceso_listo = lista_listos.primero;
-	
-	// Rellena contadores de usuario y sistema del proceso en ejecucion
-	if(proceso_listo != NULL){
-		if(viene_de_modo_usuario()){
-			p_proc_actual->veces_usuario++;
-		}
-		else{
-			p_proc_actual->veces_sistema++;
+	if(anterior == NULL){
+		insertar_primero(listos, proc);
+	}
+	else{
+		proc->siguiente = paux;
+		anterior->siguiente = proc;
+		if(paux == NULL){
+			listos->ultimo = proc;
 		}
+	}
+}
 
-		// Comprueba si ha terminado rodaja de tiempo del proceso
-		if(p_proc_actual->ticksRestantesRodaja <= 1){
-			// Si no le queda rodaja activa int SW de planificacion
-			idABloquear = p_proc_actual->id;
-			activar_int_SW();
+/*
+ * Con varios procesadores, un procesador sin procesos listos roba uno de
+ * la cola de otro. No se puede robar un proceso sobre cuya pila se est
+ * ejecutando algn procesador, ya sea en ejecucin o parado esperando
+ * en el planificador. Se roba el ltimo de la cola, que es el que ms
+ * iba a tardar en ejecutarse. Devuelve el proceso robado o NULL.
+ */
+static BCP * robar_proceso(){
+	BCP *proceso, *robado;
+	int yo = procesador_actual();
+	int i, j, victima;
+
+	for (i = 1; i < numProcesadores; i++){
+		victima = (yo + i) % numProcesadores;
+		robado = NULL;
+		for (proceso = procesadores[victima].listos.primero;
+				proceso != NULL; proceso = proceso->siguiente){
+			for (j = 0; j < numProcesadores &&
+					procesadores[j].proc_actual != proceso; j++);
+			if(j == numProcesadores){
+				robado = proceso;
+			}
 		}
-		else{
-			// Resta tick de rodaja al proceso
-			p_proc_actual->ticksRestantesRodaja--;
+		if(robado != NULL){
+			eliminar_elem(&(procesadores[victima].listos), robado);
+			robado->cpu = yo;
+			insertar_ultimo(&lista_listos, robado);
+			return robado;
 		}
 	}
+	return NULL;
+}
 
-	// Incrementa contador de llamadas a int_reloj
-	numTicks++;
-
-	// Comprueba si hay procesos que se pueden desbloquear
-	BCP *procesoADesbloquear = lista_bloqueados.primero;
-	BCP *procesoSiguiente = NULL;
-	if(procesoADesbloquear != NULL){
-		procesoSiguiente = procesoADesbloquear->siguiente;
+/*
+ * Elige el proceso a ejecutar entre los listos. Los procesos de tiempo
+ * real con presupuesto disponible tienen prioridad y entre ellos se elige
+ * el de plazo ms prximo (EDF). Si no hay ninguno se elige el primero de
+ * los procesos normales, que se turnan en round robin. Los procesos de
+ * tiempo real que han agotado su presupuesto esperan a que se renueve.
+ */
+static BCP * elegir_proceso(){
+	BCP *proceso;
+	BCP *elegido = NULL;
+
+	for (proceso = lista_listos.primero; proceso != NULL;
+			proceso = proceso->siguiente){
+		if(proceso->periodoRT > 0 &&
+				proceso->consumidoRT < proceso->presupuestoRT &&
+				(elegido == NULL || proceso->plazoRT < elegido->plazoRT)){
+			elegido = proceso;
+		}
+	}
+	if(elegido != NULL){
+		return elegido;
 	}
 
-	while(procesoADesbloquear != NULL){
-		
-		// Calculo de tiempo de bloqueo
-		int numTicksBloqueo = procesoADesbloquear->secs_bloqueo * TICK;
-		int ticksTranscurridos = numTicks - procesoADesbloquear->inicio_bloqueo;
-
-		// Comprueba si el proceso se debe desbloquear
-		if(ticksTranscurridos >= numTicksBloqueo && 
-				procesoADesbloquear->bloqueadoPorLectura == 0 &&
-				procesoADesbloquear->bloqueadoCreandoMutex == 0){
-
-			// Proceso de desbloquea y pasa a estado listo
-			procesoADesbloquear->estado = LISTO;
-
-			int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-			eliminar_elem(&lista_bloqueados, procesoADesbloquear);
-			insertar_ultimo(&lista_listos, procesoADesbloquear);
-			fijar_nivel_int(nivel_interrupciones);	
+	if(politicaPlanificacion == PLAN_CFS){
+		// El proceso en ejecucin sigue hasta agotar su rodaja salvo que
+		// otro lleve bastante menos tiempo virtual (p.ej. al despertar)
+		elegido = minimo_cfs();
+		proceso = p_proc_actual;
+		if(proceso != NULL && proceso == lista_listos.primero &&
+				proceso->periodoRT == 0 &&
+				(elegido == NULL || elegido->vruntime +
+				GRANULARIDAD_CFS * VRUNTIME_TICK >= proceso->vruntime)){
+			return proceso;
 		}
+		return elegido;
+	}
 
-		procesoADesbloquear = procesoSiguiente;
-		if(procesoADesbloquear != NULL){
-			procesoSiguiente = procesoADesbloquear->siguiente;
+	for (proceso = lista_listos.primero; proceso != NULL;
+			proceso = proceso->siguiente){
+		if(proceso->periodoRT == 0){
+			return proceso;
 		}
 	}
-    return;
+	return NULL;
 }
 
 /*
- * Tratamiento de llamadas al sistema
+ * Calcula la rodaja de CFS: LATENCIA_CFS repartida entre los procesos
+ * listos en proporcin a sus pesos, con un mnimo de GRANULARIDAD_CFS
  */
-static void tratar_llamsis(){
-	int nserv, res;
+static int rodaja_cfs(BCP *proceso){
+	int rodaja = LATENCIA_CFS * proceso->billetes /
+			(pesoArbolCFS + proceso->billetes);
 
-	nserv=leer_registro(0);
-	if (nserv<NSERVICIOS)
-		res=(tabla_servicios[nserv].fservicio)();
-	else
-		res=-1;		/* servicio no existente */
-	escribir_registro(0,res);
-	return;
+	return (rodaja < GRANULARIDAD_CFS) ? GRANULARIDAD_CFS : rodaja;
 }
 
 /*
- * Tratamiento de interrupciones software
+ * Actualiza el tiempo virtual mnimo de CFS, que nunca retrocede, con el
+ * del proceso elegido y el del primero del rbol
  */
-static void int_sw(){
-
-	printk("-> TRATANDO INT. SW\n");
-
-	// Interrupcion SW de planificacion
-	// Comprueba que proceso en ejecucin es el que se quiere bloquear
-	if(idABloquear == p_proc_actual->id){
-		// Pone el proceso ejecutando al final de la cola de listos
-		BCP *proceso = lista_listos.primero;
-		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-		eliminar_elem(&lista_listos, proceso);
-		insertar_ultimo(&lista_listos, proceso);
-		fijar_nivel_int(nivel_interrupciones);
+static void actualizar_vruntime_minimo(BCP *proceso){
+	BCP *minimo = minimo_cfs();
+	long vruntime = proceso->vruntime;
 
-		// Cambio de contexto por int sw de planificacin
-		BCP *p_proc_bloqueado = p_proc_actual;
-		p_proc_actual = planificador();
-		cambio_contexto(&(p_proc_bloqueado->contexto_regs), &(p_proc_actual->contexto_regs));
+	if(minimo != NULL && minimo->vruntime < vruntime){
+		vruntime = minimo->vruntime;
+	}
+	if(vruntime > vruntimeMinimo){
+		vruntimeMinimo = vruntime;
 	}
-
-	return;
 }
 
 /*
- *
- * Funcion auxiliar que crea un proceso reservando sus recursos.
- * Usada por llamada crear_proceso.
- *
+ * Publica en la pgina de datos el reloj, el proceso en ejecucin, las
+ * estadsticas del planificador y los tiempos de todos los procesos. Se
+ * invoca con el nivel de interrupcin en NIVEL_3 para que no se aniden
+ * dos actualizaciones; el contador de secuencia es impar mientras dura.
  */
-static int crear_tarea(char *prog){
-
-	void * imagen, *pc_inicial;
-	int error=0;
-	int proc;
-	BCP *p_proc;
-
-	proc=buscar_BCP_libre();
-	if (proc==-1)
-		return -1;	/* no hay entrada libre */
+static void actualizar_pagina_datos(BCP *actual){
+	int i;
 
-	/* A rellenar el BCP ... */
-	p_proc=&(tabla_procs[proc]);
+	if(paginaDatos == NULL){
+		return;
+	}
 
-	/* crea la imagen de memoria leyendo ejecutable */
-	imagen=crear_imagen(prog, &pc_inicial);
-	if (imagen)
-	{
-		p_proc->info_mem=imagen;
-		p_proc->pila=crear_pila(TAM_PILA);
-		fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
-			pc_inicial,
-			&(p_proc->contexto_regs));
-		p_proc->id=proc;
-		p_proc->estado=LISTO;
+	__atomic_fetch_add(&paginaDatos->secuencia, 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
 
-		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-		/* lo inserta al final de cola de listos */
-		insertar_ultimo(&lista_listos, p_proc);
-		fijar_nivel_int(nivel_interrupciones);
-		error= 0;
+	paginaDatos->procesadores = numProcesadores;
+	paginaDatos->ticks = numTicks;
+	if(actual != NULL){
+		paginaDatos->id_actual = actual->id;
+	}
+	paginaDatos->cambios_contexto = cambiosContexto;
+	paginaDatos->politica = politicaPlanificacion;
+	for (i = 0; i < MAX_PROC; i++){
+		paginaDatos->tiempos[i].usuario = tabla_procs[i].veces_usuario;
+		paginaDatos->tiempos[i].sistema = tabla_procs[i].veces_sistema;
 	}
-	else
-		error= -1; /* fallo al crear imagen */
 
-	return error;
+	__atomic_fetch_add(&paginaDatos->secuencia, 1, __ATOMIC_RELEASE);
 }
 
 /*
- *
- * Rutinas que llevan a cabo las llamadas al sistema
- *	sis_crear_proceso sis_escribir
- *
+ * Funcin de planificacion: EDF para los procesos de tiempo real y la
+ * poltica seleccionada (round robin, stride o CFS) para el resto.
  */
+static BCP * planificador(){
+	BCP *proceso;
 
-/*
- * Tratamiento de llamada al sistema crear_proceso. Llama a la
- * funcion auxiliar crear_tarea sis_terminar_proceso
- */
-int sis_crear_proceso(){
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	while ((proceso = elegir_proceso()) == NULL)
+		if (robar_proceso() == NULL)
+			espera_int();	/* No hay nada que hacer */
+
+	// El proceso en ejecucin debe estar al principio de la cola de listos
+	// y fuera del rbol de CFS
+	if(proceso != lista_listos.primero){
+		eliminar_elem(&lista_listos, proceso);
+		insertar_primero(&lista_listos, proceso);
+	}
+	if(proceso->enArbolCFS){
+		desencolar_cfs(proceso);
+	}
+
+	if(proceso != p_proc_actual){
+		cambiosContexto++;
+	}
+	actualizar_pagina_datos(proceso);
+	fijar_nivel_int(nivel_interrupciones);
+
+	// Asigna rodaja al proceso
+	if(politicaPlanificacion == PLAN_CFS && proceso->periodoRT == 0){
+		proceso->ticksRestantesRodaja = rodaja_cfs(proceso);
+	}
+	else{
+		proceso->ticksRestantesRodaja = ticksPorRodaja;
+	}
+
+	// Avanza el tiempo virtual de stride o CFS
+	if(proceso->periodoRT == 0 && proceso->paso > pasoGlobal){
+		pasoGlobal = proceso->paso;
+	}
+	if(politicaPlanificacion == PLAN_CFS && proceso->periodoRT == 0){
+		actualizar_vruntime_minimo(proceso);
+	}
+
+	return proceso;
+}
+
+/*
+ * Comienza un nuevo periodo en los procesos de tiempo real cuyo plazo
+ * ha vencido, renovando su presupuesto. Si el trabajo del periodo no
+ * haba terminado cuenta un plazo incumplido. Se invoca desde int_reloj.
+ */
+static void renovar_trabajos_rt(){
+	int i;
+
+	for (i = 0; i < MAX_PROC; i++){
+		BCP *proceso = &(tabla_procs[i]);
+
+		if(proceso->estado != NO_USADA && proceso->periodoRT > 0 &&
+				numTicks >= proceso->plazoRT){
+			if(!proceso->trabajoTerminado){
+				proceso->fallosPlazo++;
+			}
+			proceso->plazoRT += proceso->periodoRT;
+			proceso->consumidoRT = 0;
+			proceso->trabajoTerminado = 0;
+		}
+	}
+}
+
+/*
+ * Carga un tick de UCP a la cuota del grupo del proceso en ejecucin,
+ * que queda estrangulado si la agota. Se invoca desde int_reloj.
+ */
+static void cobrar_cuota(BCP *proceso){
+	cuota_grupo *c = &(cuotas_grupo[proceso->grupo]);
+
+	c->consumido++;
+	c->total++;
+	if(c->cuota > 0 && !c->estrangulado && c->consumido >= c->cuota){
+		c->estrangulado = 1;
+		c->vecesEstrangulado++;
+	}
+}
+
+/*
+ * Devuelve a los listos a los procesos de un grupo que ha dejado de
+ * estar estrangulado
+ */
+static void liberar_estrangulados(int grupo){
+	BCP *proceso = lista_estrangulados.primero;
+
+	cuotas_grupo[grupo].estrangulado = 0;
+	while(proceso != NULL){
+		BCP *procesoSiguiente = proceso->siguiente;
+
+		if(proceso->grupo == grupo){
+			proceso->estado = LISTO;
+			eliminar_elem(&lista_estrangulados, proceso);
+			insertar_listo(proceso);
+		}
+		proceso = procesoSiguiente;
+	}
+}
+
+/*
+ * Comienza un nuevo periodo en los grupos con cuota cuyo periodo ha
+ * vencido, liberando a los que estaban estrangulados. Se invoca desde
+ * int_reloj.
+ */
+static void renovar_cuotas(){
+	int i;
+
+	for (i = 0; i < MAX_PROC; i++){
+		cuota_grupo *c = &(cuotas_grupo[i]);
+
+		if(c->cuota == 0){
+			continue;
+		}
+		if(c->estrangulado){
+			c->ticksEstrangulado++;
+		}
+		if(numTicks >= c->inicioPeriodo + c->periodo){
+			c->inicioPeriodo = numTicks;
+			c->consumido = 0;
+			if(c->estrangulado){
+				liberar_estrangulados(i);
+			}
+		}
+	}
+}
+
+/*
+ * Cuenta los procesos listos o en ejecucin y los bloqueados esperando un
+ * mutex, que no esperan por decisin propia sino por un recurso ocupado
+ * (como la espera no interrumpible de Linux)
+ */
+static void contar_activos(int *ejecutables, int *bloqueados){
+	int i;
+
+	*ejecutables = 0;
+	*bloqueados = 0;
+	for (i = 0; i < MAX_PROC; i++){
+		BCP *proceso = &(tabla_procs[i]);
+
+		if(proceso->estado == LISTO){
+			(*ejecutables)++;
+		}
+		else if(proceso->estado == BLOQUEADO &&
+				((proceso->bloqueadoPorMutex != NULL &&
+				proceso->listaEspera == &(proceso->bloqueadoPorMutex->esperando)) ||
+				proceso->bloqueadoCreandoMutex)){
+			(*bloqueados)++;
+		}
+	}
+}
+
+/*
+ * Aplica a una media en coma fija el decaimiento exponencial con el
+ * nuevo valor, redondeando hacia l como calc_load en Linux
+ */
+static int decaer_media(int media, int exp, int valor){
+	int nueva = media * exp + valor * (UNO_CARGA - exp);
+
+	if(valor >= media){
+		nueva += UNO_CARGA - 1;
+	}
+	return nueva >> BITS_CARGA;
+}
+
+/*
+ * Acumula la carga y la presin del tick y, al acabar cada intervalo,
+ * recalcula con sus valores medios las cargas medias y la presin. Hay
+ * presin en un tick si algn proceso listo espera sin procesador. Se
+ * invoca desde int_reloj.
+ */
+static void medir_carga(){
+	int i, ejecutables, bloqueados, ejecutando = 0;
+
+	contar_activos(&ejecutables, &bloqueados);
+	for (i = 0; i < numProcesadores; i++){
+		if(!procesadores[i].ocioso){
+			ejecutando++;
+		}
+	}
+	sumaActivos += ejecutables + bloqueados;
+	if(ejecutables > ejecutando){
+		ticksPresionIntervalo++;
+		ticksPresion++;
+	}
+
+	if(numTicks % intervaloCarga == 0){
+		int activos = sumaActivos * UNO_CARGA / intervaloCarga;
+		int presion = ticksPresionIntervalo * UNO_CARGA / intervaloCarga;
+
+		for (i = 0; i < NUM_MEDIAS_CARGA; i++){
+			cargaMedia[i] = decaer_media(cargaMedia[i], expCarga[i], activos);
+			presionMedia[i] = decaer_media(presionMedia[i], expCarga[i], presion);
+		}
+		sumaActivos = 0;
+		ticksPresionIntervalo = 0;
+	}
+}
+
+/*
+ * Fija el intervalo de reclculo de las cargas medias segn el tick y
+ * calcula sus factores de decaimiento exp(-intervalo/constante) con la
+ * serie de Taylor en coma fija, ya que el kernel no usa coma flotante.
+ * Se invoca en el arranque, tras leer los parmetros.
+ */
+static void iniciar_medias_carga(){
+	const long long uno = 1LL << 30;
+	long long suma, termino, divisor;
+	int i, n;
+
+	intervaloCarga = ticksPorSegundo / INTERVALOS_CARGA_POR_SEG;
+	if(intervaloCarga < 1){
+		intervaloCarga = 1;
+	}
+	for (i = 0; i < NUM_MEDIAS_CARGA; i++){
+		// x = intervaloCarga/divisor segundos entre la constante
+		divisor = (long long)ticksPorSegundo * segundosCarga[i];
+		suma = termino = uno;
+		for (n = 1; termino != 0; n++){
+			termino = -termino * intervaloCarga / (divisor * n);
+			suma += termino;
+		}
+		expCarga[i] = (int)((suma * UNO_CARGA + uno / 2) / uno);
+	}
+}
+
+/*
+ *
+ * Funciones auxiliares para bloquear y desbloquear procesos en listas
+ * de espera de objetos de sincronizacion
+ *	bloquear_proceso desbloquear_proceso
+ *
+ */
+
+static void liberar_proceso();
+
+/*
+ * Termina el proceso actual si, mientras estaba bloqueado o expulsado, se
+ * ha terminado su grupo desde otro procesador. Se llama justo despus de
+ * cada cambio de contexto por el que puede volver a ejecutar un proceso.
+ */
+static void comprobar_terminacion(){
+	if(p_proc_actual->terminarPendiente){
+		printk("-> FIN PROCESO %d\n", p_proc_actual->id);
+		liberar_proceso();
+	}
+}
+
+/*
+ * Bloquea el proceso actual al final de la lista de espera y cede la UCP.
+ * Se debe invocar con el nivel de interrupcion en NIVEL_3, de manera que
+ * la comprobacion de la condicion de bloqueo y el bloqueo sean atomicos
+ * respecto a int_reloj.
+ */
+static void bloquear_proceso(lista_BCPs *lista){
+	BCP *proceso_bloqueado = p_proc_actual;
+
+	proceso_bloqueado->estado = BLOQUEADO;
+	proceso_bloqueado->listaEspera = lista;
+	eliminar_elem(&lista_listos, proceso_bloqueado);
+	insertar_ultimo(lista, proceso_bloqueado);
+
+	// Cambio de contexto voluntario
+	p_proc_actual = planificador();
+	cambio_contexto(&(proceso_bloqueado->contexto_regs), &(p_proc_actual->contexto_regs));
+	comprobar_terminacion();
+}
+
+/*
+ * Pasa a listo el primer proceso de la lista de espera (orden FIFO)
+ */
+static BCP * desbloquear_proceso(lista_BCPs *lista){
+	BCP *proceso = lista->primero;
+
+	if(proceso != NULL){
+		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+		eliminar_primero(lista);
+		proceso->estado = LISTO;
+		insertar_listo(proceso);
+		fijar_nivel_int(nivel_interrupciones);
+	}
+	return proceso;
+}
+
+/*
+ *
+ * Funciones auxiliares de la espera de mltiples eventos y temporizadores
+ *	notificar_evento vencer_esperas_eventos vencer_temporizadores
+ *	rearmar_temporizador
+ *
+ */
+
+/*
+ * Despierta a los procesos bloqueados en esperar_eventos que incluyen
+ * el objeto en su conjunto de eventos. Al despertar vuelven a comprobar
+ * todos sus eventos, por lo que basta con avisar cuando un objeto puede
+ * haber pasado a estar listo.
+ */
+static void notificar_evento(void *obj){
+	int i;
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	BCP *proceso = lista_esperando_eventos.primero;
+	while(proceso != NULL){
+		BCP *procesoSiguiente = proceso->siguiente;
+
+		for (i = 0; i < proceso->numEventos; i++){
+			if(proceso->eventos[i].objeto == obj){
+				proceso->estado = LISTO;
+				eliminar_elem(&lista_esperando_eventos, proceso);
+				insertar_listo(proceso);
+				break;
+			}
+		}
+		proceso = procesoSiguiente;
+	}
+	fijar_nivel_int(nivel_interrupciones);
+}
+
+/*
+ * Despierta a los procesos cuya espera de eventos ha alcanzado el plazo.
+ * Se invoca desde int_reloj.
+ */
+static void vencer_esperas_eventos(){
+	BCP *proceso = lista_esperando_eventos.primero;
+
+	while(proceso != NULL){
+		BCP *procesoSiguiente = proceso->siguiente;
+
+		if(proceso->finEsperaEventos != SIN_PLAZO &&
+				numTicks >= proceso->finEsperaEventos){
+			proceso->estado = LISTO;
+			eliminar_elem(&lista_esperando_eventos, proceso);
+			insertar_listo(proceso);
+		}
+		proceso = procesoSiguiente;
+	}
+}
+
+/*
+ * Despierta a los procesos que esperan en temporizadores vencidos y avisa
+ * a los que esperan por ellos en esperar_eventos. Se invoca desde
+ * int_reloj.
+ */
+static void vencer_temporizadores(){
+	int i;
+
+	for (i = 0; i < NUM_OBJ; i++){
+		objeto *tmp = &(array_objetos[i]);
+
+		if(tmp->tipo == OBJ_TEMPORIZADOR && numTicks >= tmp->vencimiento){
+			while(desbloquear_proceso(&(tmp->esperando)) != NULL);
+			notificar_evento(tmp);
+		}
+	}
+}
+
+/*
+ * Rearma un temporizador vencido sumando periodos a su vencimiento
+ * anterior, no al instante actual, de manera que el retraso en atenderlo
+ * no se acumula. Devuelve el nmero de vencimientos transcurridos.
+ */
+static int rearmar_temporizador(objeto *tmp){
+	int vencimientos = (numTicks - tmp->vencimiento) / tmp->periodo + 1;
+
+	tmp->vencimiento += vencimientos * tmp->periodo;
+	return vencimientos;
+}
+
+/*
+ *
+ * Funciones de las caches de bloques del kernel
+ *	alinear_arena crear_arena reservar_arena iniciar_caches cache_de
+ *	reservar_bloque
+ *	liberar_bloque
+ *
+ */
+
+/*
+ * Redondea un tamao a la alineacin de las zonas de la arena
+ */
+static int alinear_arena(int tam){
+	return (tam + ALINEACION_ARENA - 1) & ~(ALINEACION_ARENA - 1);
+}
+
+/*
+ * Crea la arena con sitio para tam bytes, ya alineados, adems de las
+ * losas iniciales de las caches. Su contenido empieza a cero.
+ */
+static void crear_arena(int tam){
+	tamArena = tam + ARENA_CACHES;
+	if((arena = calloc(1, tamArena)) == NULL){
+		panico("no hay memoria para la arena del kernel");
+	}
+}
+
+/*
+ * Reparte memoria de la arena, que no se libera nunca. Devuelve NULL si
+ * no queda suficiente.
+ */
+static void * reservar_arena(int tam){
+	void *zona;
+
+	tam = alinear_arena(tam);
+	if(arena == NULL || usadoArena + tam > tamArena){
+		return NULL;
+	}
+	zona = arena + usadoArena;
+	usadoArena += tam;
+	return zona;
+}
+
+/*
+ * Aade a la cache una losa de bloques, de la arena o del heap
+ */
+static int crecer_cache(cache_bloques *cache){
+	int tam = cache->tamBloque > TAM_LOSA ? cache->tamBloque : TAM_LOSA;
+	char *losa;
+	int i;
+
+	if((losa = reservar_arena(tam)) == NULL){
+		if((losa = malloc(tam)) == NULL){
+			return -1;
+		}
+		tamHeapCaches += tam;
+	}
+	for (i = 0; i + cache->tamBloque <= tam; i += cache->tamBloque){
+		*(void **)(losa + i) = cache->libres;
+		cache->libres = losa + i;
+		cache->bloques++;
+	}
+	return 0;
+}
+
+/*
+ * Da una losa de la arena a cada una de las caches pequeas, de manera
+ * que su primer uso no pide memoria al heap
+ */
+static void iniciar_caches(){
+	int i;
+
+	for (i = 0; i < NUM_CACHES; i++){
+		caches[i].tamBloque = TAM_MIN_BLOQUE << i;
+		if(i < CACHES_EN_ARENA){
+			crecer_cache(&(caches[i]));
+		}
+	}
+}
+
+/*
+ * Devuelve la cache con los bloques ms pequeos en que cabe tam
+ */
+static cache_bloques * cache_de(unsigned int tam){
+	int i;
+
+	for (i = 0; i < NUM_CACHES; i++){
+		if(tam <= caches[i].tamBloque){
+			return &(caches[i]);
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Reserva un bloque de al menos tam bytes. Devuelve NULL si es mayor que
+ * el de la ltima cache o no se puede hacer crecer la suya.
+ */
+static void * reservar_bloque(unsigned int tam){
+	cache_bloques *cache = cache_de(tam);
+	void *bloque;
+
+	if(cache == NULL){
+		return NULL;
+	}
+	if(cache->libres == NULL && crecer_cache(cache) < 0){
+		cache->fallos++;
+		return NULL;
+	}
+	bloque = cache->libres;
+	cache->libres = *(void **)bloque;
+	cache->reservas++;
+	if(++cache->usados > cache->maxUsados){
+		cache->maxUsados = cache->usados;
+	}
+	return bloque;
+}
+
+/*
+ * Devuelve a su cache un bloque reservado con el mismo tam
+ */
+static void liberar_bloque(void *bloque, unsigned int tam){
+	cache_bloques *cache = cache_de(tam);
+
+	*(void **)bloque = cache->libres;
+	cache->libres = bloque;
+	cache->usados--;
+}
+
+/*
+ *
+ * Funciones auxiliares de las llamadas asncronas
+ *	nueva_asinc completar_asinc primera_asinc lock_asinc_pendiente
+ *	vencer_asinc cancelar_asinc sacar_caracter
+ *	soltar_caracter_reservado
+ *
+ */
+
+/*
+ * Reserva una peticin asncrona para el proceso actual. Devuelve NULL
+ * si el proceso tiene ya todas las que puede o no hay ninguna libre.
+ */
+static peticion_asinc * nueva_asinc(int tipo){
+	int i;
+
+	if(p_proc_actual->numAsinc >= MAX_ASINC_PROC){
+		return NULL;
+	}
+	for (i = 0; i < MAX_ASINC; i++){
+		peticion_asinc *pet = &(array_asinc[i]);
+
+		if(pet->tipo == ASINC_LIBRE){
+			// El testigo es siempre positivo para distinguirlo de un error
+			if(++p_proc_actual->ultimoTestigo <= 0){
+				p_proc_actual->ultimoTestigo = 1;
+			}
+			pet->tipo = tipo;
+			pet->proceso = p_proc_actual;
+			pet->testigo = p_proc_actual->ultimoTestigo;
+			pet->turno = ++ultimoTurno;
+			pet->m = NULL;
+			p_proc_actual->numAsinc++;
+			return pet;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Libera la peticin y deja su terminacin en la cola del proceso, que
+ * siempre tiene hueco para ella, despertndolo si la est esperando
+ */
+static void completar_asinc(peticion_asinc *pet, int resultado){
+	BCP *proceso = pet->proceso;
+	int pos;
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	pos = (proceso->primeraTerminacion + proceso->numTerminaciones) %
+		MAX_ASINC_PROC;
+	proceso->terminaciones[pos].testigo = pet->testigo;
+	proceso->terminaciones[pos].resultado = resultado;
+	proceso->numTerminaciones++;
+	pet->tipo = ASINC_LIBRE;
+
+	if(proceso->esperandoTerminaciones){
+		proceso->esperandoTerminaciones = 0;
+		proceso->estado = LISTO;
+		eliminar_elem(&lista_esperando_terminaciones, proceso);
+		insertar_listo(proceso);
+	}
+	fijar_nivel_int(nivel_interrupciones);
+}
+
+/*
+ * Devuelve la peticin pendiente ms antigua de un tipo (y mutex, en
+ * ASINC_LOCK) o NULL si no hay ninguna
+ */
+static peticion_asinc * primera_asinc(int tipo, mutex *m){
+	peticion_asinc *primera = NULL;
+	int i;
+
+	for (i = 0; i < MAX_ASINC; i++){
+		peticion_asinc *pet = &(array_asinc[i]);
+
+		if(pet->tipo == tipo && pet->m == m &&
+				(primera == NULL || pet->turno < primera->turno)){
+			primera = pet;
+		}
+	}
+	return primera;
+}
+
+/*
+ * Indica si el proceso actual tiene un lock asncrono pendiente sobre el
+ * mutex
+ */
+static int lock_asinc_pendiente(mutex *m){
+	int i;
+
+	for (i = 0; i < MAX_ASINC; i++){
+		if(array_asinc[i].tipo == ASINC_LOCK && array_asinc[i].m == m &&
+				array_asinc[i].proceso == p_proc_actual){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Completa las peticiones de dormir que han vencido. Se invoca desde
+ * int_reloj.
+ */
+static void vencer_asinc(){
+	int i;
+
+	for (i = 0; i < MAX_ASINC; i++){
+		peticion_asinc *pet = &(array_asinc[i]);
+
+		if(pet->tipo == ASINC_DORMIR && numTicks >= pet->fin){
+			completar_asinc(pet, 0);
+		}
+	}
+}
+
+/*
+ * Anula las peticiones pendientes del proceso actual sobre un mutex
+ * (todas si es NULL). Las de un mutex que cierra terminan con -1; las de
+ * un proceso que termina se descartan.
+ */
+static void cancelar_asinc(mutex *m){
+	int i;
+
+	for (i = 0; i < MAX_ASINC; i++){
+		peticion_asinc *pet = &(array_asinc[i]);
+
+		if(pet->tipo == ASINC_LIBRE || pet->proceso != p_proc_actual){
+			continue;
+		}
+		if(m == NULL){
+			pet->tipo = ASINC_LIBRE;
+		}
+		else if(pet->tipo == ASINC_LOCK && pet->m == m){
+			completar_asinc(pet, -1);
+		}
+	}
+}
+
+/*
+ * Extrae el primer caracter del buffer del terminal, que no est vaco
+ */
+static char sacar_caracter(){
+	int i;
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_2);
+	char car = bufferCaracteres[0];
+	caracteresEnBuffer--;
+
+	// Reordena el buffer
+	for (i = 0; i < caracteresEnBuffer; i++){
+		bufferCaracteres[i] = bufferCaracteres[i+1];
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return car;
+}
+
+/*
+ * Deja de guardar un caracter al proceso si se le despert para leerlo
+ */
+static void soltar_caracter_reservado(BCP *proceso){
+	if(proceso->caracterReservado){
+		proceso->caracterReservado = 0;
+		caracteresReservados--;
+	}
+}
+
+/*
+ *
+ * Funciones auxiliares de mutex y objetos de sincronizacion
+ *	liberar_mutex cerrar_mutex_proceso cerrar_objeto_proceso
+ *
+ */
+
+/*
+ * Cede el mutex al primer proceso que espera por l, bloqueado o con una
+ * peticin asncrona, o lo deja libre. El proceso despertado ya es
+ * propietario del mutex.
+ */
+static void liberar_mutex(mutex *m){
+	BCP *proceso = m->esperando.primero;
+	peticion_asinc *pet = primera_asinc(ASINC_LOCK, m);
+
+	if(pet != NULL && (proceso == NULL || pet->turno < proceso->turnoEspera)){
+		m->propietario = pet->proceso->id;
+		m->numLocks = 1;
+		completar_asinc(pet, 0);
+		return;
+	}
+	if(proceso == NULL){
+		m->propietario = -1;
+		m->numLocks = 0;
+		notificar_evento(m);
+		return;
+	}
+	m->propietario = proceso->id;
+	m->numLocks = proceso->numLocksPendientes;
+	proceso->bloqueadoPorMutex = NULL;
+	desbloquear_proceso(&(m->esperando));
+}
+
+/*
+ * Desbloquea a los procesos que esperaban para crear un mutex porque se
+ * haba alcanzado el mximo, tras eliminarse alguno
+ */
+static void despertar_creadores_mutex(){
+	BCP *procesoADesbloquear = lista_bloqueados.primero;
+	BCP *procesoSiguiente = NULL;
+	if(procesoADesbloquear != NULL){
+		procesoSiguiente = procesoADesbloquear->siguiente;
+	}
+
+	while(procesoADesbloquear != NULL){
+
+		if(procesoADesbloquear->bloqueadoCreandoMutex == 1){
+			procesoADesbloquear->estado = LISTO;
+			procesoADesbloquear->bloqueadoCreandoMutex = 0;
+			int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+			eliminar_elem(&lista_bloqueados, procesoADesbloquear);
+			insertar_listo(procesoADesbloquear);
+			fijar_nivel_int(nivel_interrupciones);
+		}
+		procesoADesbloquear = procesoSiguiente;
+		if(procesoADesbloquear != NULL){
+			procesoSiguiente = procesoADesbloquear->siguiente;
+		}
+	}
+}
+
+/*
+ * Cierra un descriptor de mutex del proceso actual. Si el proceso tena
+ * el mutex bloqueado lo libera y, si nadie ms lo tiene abierto, lo elimina
+ * desbloqueando a los procesos que esperaban para crear un mutex.
+ */
+static void cerrar_mutex_proceso(int desc){
+	mutex *m = p_proc_actual->array_mutex_proceso[desc];
+	int cerrarMutex = 1;
+	int k;
+
+	// Elimina mutex local abierto
+	p_proc_actual->numMutex--;
+	p_proc_actual->array_mutex_proceso[desc] = NULL;
+
+	// Libera el mutex si lo tena bloqueado el proceso
+	if(m->numLocks > 0 && m->propietario == p_proc_actual->id){
+		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+		liberar_mutex(m);
+		fijar_nivel_int(nivel_interrupciones);
+	}
+
+	// Sigue abierto por el proceso si tiene otro descriptor del mismo mutex
+	m->procesos[p_proc_actual->id] = 0;
+	for (k = 0; k < numMutProc; k++){
+		if(p_proc_actual->array_mutex_proceso[k] == m){
+			m->procesos[p_proc_actual->id] = 1;
+		}
+	}
+
+	// Si ya no lo tiene abierto, anula sus lock asncronos pendientes
+	if(m->procesos[p_proc_actual->id] == 0){
+		cancelar_asinc(m);
+	}
+
+	for (k = 0; k < MAX_PROC && cerrarMutex == 1; k++){
+		if(m->procesos[k] == 1){
+			// No hay que cerrar mutex, ya que est abierto por otro proceso
+			cerrarMutex = 0;
+		}
+	}
+
+	if(cerrarMutex == 1){
+		// Eliminar el mutex global
+		mutexExistentes--;
+		m->nombre[0] = '\0';
+
+		// Desbloquea procesos esperando para crear mutex
+		despertar_creadores_mutex();
+	}
+}
+
+/*
+ * Suelta una referencia a un objeto, liberndolo (y la zona de memoria
+ * si es un segmento o una cola) si era la ltima
+ */
+static void soltar_objeto(objeto *obj){
+	obj->referencias--;
+	if(obj->referencias == 0){
+		if(obj->tipo == OBJ_MEMORIA){
+			liberar_bloque(obj->memoria, obj->tam);
+			obj->memoria = NULL;
+		}
+		else if(obj->tipo == OBJ_COLA){
+			liberar_bloque(obj->memoria, obj->capacidad * obj->tam);
+			obj->memoria = NULL;
+		}
+		obj->tipo = OBJ_LIBRE;
+	}
+}
+
+/*
+ * Cierra un descriptor de objeto del proceso actual, liberando el objeto
+ * (y la zona de memoria si es un segmento) si no quedan descriptores
+ * abiertos sobre l
+ */
+static void cerrar_objeto_proceso(int desc){
+	objeto *obj = p_proc_actual->array_objetos_proceso[desc];
+
+	p_proc_actual->numObjetos--;
+	p_proc_actual->array_objetos_proceso[desc] = NULL;
+
+	soltar_objeto(obj);
+}
+
+/*
+ * Deja la imagen de una tarea que ya est TERMINADO, liberndola si no la
+ * comparte con ninguna otra. Si es un hilo, deja su valor de terminacin
+ * para quien lo espere.
+ */
+static void soltar_imagen(BCP *proceso){
+	hilo *h = &(tabla_hilos[proceso->id]);
+	int i;
+
+	if(h->imagen != NULL){
+		h->terminado = 1;
+		h->valor = proceso->valorSalida;
+		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+		while(desbloquear_proceso(&lista_esperando_hilos) != NULL);
+		fijar_nivel_int(nivel_interrupciones);
+	}
+
+	for (i = 0; i < MAX_PROC; i++){
+		if(tabla_procs[i].estado != NO_USADA &&
+				tabla_procs[i].info_mem == proceso->info_mem){
+			return;
+		}
+	}
+	liberar_imagen(proceso->info_mem);
+
+	// Nadie recoger ya el valor de sus hilos
+	for (i = 0; i < MAX_PROC; i++){
+		if(tabla_hilos[i].imagen == proceso->info_mem){
+			tabla_hilos[i].imagen = NULL;
+		}
+	}
+}
+
+/*
+ *
+ * Funcion auxiliar que termina proceso actual liberando sus recursos.
+ * Usada por llamada terminar_proceso y por rutinas que tratan excepciones
+ *
+ */
+static void liberar_proceso(){
+	BCP * p_proc_anterior;
+
+	// Descarta sus peticiones asncronas pendientes y el caracter que
+	// tuviera guardado
+	cancelar_asinc(NULL);
+	soltar_caracter_reservado(p_proc_actual);
+
+ 	// Cierra los mutex abiertos, liberando los que tenga bloqueados
+	int i;
+	for (i = 0; i < numMutProc; i++){
+		if (p_proc_actual->array_mutex_proceso[i] != NULL){
+			cerrar_mutex_proceso(i);
+		}
+	}
+
+	// Cierra los semaforos, condiciones y segmentos de memoria abiertos
+	for (i = 0; i < NUM_OBJ_PROC; i++){
+		if (p_proc_actual->array_objetos_proceso[i] != NULL){
+			cerrar_objeto_proceso(i);
+		}
+	}
+
+	p_proc_actual->estado=TERMINADO;
+
+	soltar_imagen(p_proc_actual); /* liberar mapa si no lo comparte */
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	eliminar_primero(&lista_listos); /* proc. fuera de listos */
+	fijar_nivel_int(nivel_interrupciones);
+
+	/* sin procesos ya no puede ocurrir nada: se apaga el sistema */
+	if (!quedan_procesos()){
+		printk("-> NO QUEDAN PROCESOS: SE APAGA EL SISTEMA EN EL TICK %d\n",
+			numTicks);
+		apagar();
+	}
+
+	/* Realizar cambio de contexto */
+	p_proc_anterior=p_proc_actual;
+	p_proc_actual=planificador();
+
+	printk("-> C.CONTEXTO POR FIN: de %d a %d\n",
+			p_proc_anterior->id, p_proc_actual->id);
+
+	liberar_pila(p_proc_anterior->pila);
+	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
+        return; /* no debera llegar aqui */
+}
+
+/*
+ *
+ * Funciones relacionadas con el tratamiento de interrupciones
+ *	excepciones: exc_arit exc_mem
+ *	interrupciones de reloj: int_reloj
+ *	interrupciones del terminal: int_terminal
+ *	llamadas al sistemas: llam_sis
+ *	interrupciones SW: int_sw
+ *
+ */
+
+/*
+ * Tratamiento de excepciones aritmeticas
+ */
+static void exc_arit(){
+
+	if (!viene_de_modo_usuario())
+		panico("excepcion aritmetica cuando estaba dentro del kernel");
+
+
+	printk("-> EXCEPCION ARITMETICA EN PROC %d\n", p_proc_actual->id);
+	liberar_proceso();
+
+        return; /* no debera llegar aqui */
+}
+
+/*
+ * Tratamiento de excepciones en el acceso a memoria
+ */
+static void exc_mem(){
+
+	if(accesoParam == 0){
+		if (!viene_de_modo_usuario()){
+			panico("excepcion de memoria cuando estaba dentro del kernel");
+		}
+	}
+	accesoParam = 0;
+
+	printk("-> EXCEPCION DE MEMORIA EN PROC %d\n", p_proc_actual->id);
+	liberar_proceso();
+
+        return; /* no debera llegar aqui */
+}
+
+/*
+ * Tratamiento de interrupciones de terminal
+ */
+static void int_terminal(){
+	char car;
+	car = leer_puerto(DIR_TERMINAL);
+	printk("-> TRATANDO INT. DE TERMINAL %c\n", car);
+
+	// si el buffer no est lleno introduce el caracter nuevo
+	if(caracteresEnBuffer < tamBufTerm){
+		bufferCaracteres[caracteresEnBuffer] = car;
+		caracteresEnBuffer++;		
+
+		// avisa a los procesos que esperan eventos del terminal
+		notificar_evento(bufferCaracteres);
+
+		// busca el primer proceso bloqueado por lectura
+		BCP *proceso_bloqueado = lista_bloqueados.primero;
+		while(proceso_bloqueado != NULL &&
+				proceso_bloqueado->bloqueadoPorLectura != 1){
+			proceso_bloqueado = proceso_bloqueado->siguiente;
+		}
+
+		// si una lectura asncrona lleg antes, recibe ella el caracter
+		peticion_asinc *pet = primera_asinc(ASINC_LEER, NULL);
+		if(pet != NULL && (proceso_bloqueado == NULL ||
+				pet->turno < proceso_bloqueado->turnoEspera)){
+			completar_asinc(pet, (long)sacar_caracter());
+		}
+		else if(proceso_bloqueado != NULL){
+			// Desbloquear proceso guardndole el caracter hasta que
+			// vuelva a ejecutar
+			proceso_bloqueado->estado = LISTO;
+			proceso_bloqueado->bloqueadoPorLectura = 0;
+			proceso_bloqueado->caracterReservado = 1;
+			caracteresReservados++;
+			int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+			eliminar_elem(&lista_bloqueados, proceso_bloqueado);
+			insertar_listo(proceso_bloqueado);
+			fijar_nivel_int(nivel_interrupciones);
+		}
+	}
+    return;
+}
+
+/*
+ * Parte del tratamiento de la interrupcin de reloj que es global al
+ * sistema: avanza el tiempo y despierta a los procesos cuyo plazo ha
+ * vencido. Con varios procesadores cada uno recibe su tick, pero esto
+ * slo lo hace el primero.
+ */
+static void avanzar_reloj(){
+
+	// Incrementa contador de llamadas a int_reloj
+	numTicks++;
+
+	// Comienza periodo en los procesos de tiempo real cuyo plazo ha vencido
+	renovar_trabajos_rt();
+
+	// Y en los grupos con cuota de UCP
+	renovar_cuotas();
+
+	// Actualiza las cargas medias
+	medir_carga();
+
+	// Comprueba si hay procesos que se pueden desbloquear
+	BCP *procesoADesbloquear = lista_bloqueados.primero;
+	BCP *procesoSiguiente = NULL;
+	if(procesoADesbloquear != NULL){
+		procesoSiguiente = procesoADesbloquear->siguiente;
+	}
+
+	while(procesoADesbloquear != NULL){
+		
+		// Comprueba si el proceso se debe desbloquear
+		if(numTicks >= procesoADesbloquear->fin_bloqueo && 
+				procesoADesbloquear->bloqueadoPorLectura == 0 &&
+				procesoADesbloquear->bloqueadoCreandoMutex == 0){
+
+			// Proceso de desbloquea y pasa a estado listo
+			procesoADesbloquear->estado = LISTO;
+
+			int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+			eliminar_elem(&lista_bloqueados, procesoADesbloquear);
+			insertar_listo(procesoADesbloquear);
+			fijar_nivel_int(nivel_interrupciones);	
+		}
+
+		procesoADesbloquear = procesoSiguiente;
+		if(procesoADesbloquear != NULL){
+			procesoSiguiente = procesoADesbloquear->siguiente;
+		}
+	}
+
+	// Comprueba si ha vencido algun temporizador
+	vencer_temporizadores();
+
+	// Comprueba si ha vencido alguna espera de eventos
+	vencer_esperas_eventos();
+
+	// Completa las peticiones asncronas de dormir que han vencido
+	vencer_asinc();
+}
+
+/*
+ * Tratamiento de interrupciones de reloj
+ */
+static void int_reloj(){
+
+	//printk("-> TRATANDO INT. DE RELOJ\n");
+
+	BCP *proceso_listo = lista_listos.primero;
+	
+	// Rellena contadores de usuario y sistema del proceso en ejecucion
+	if(proceso_listo != NULL && !procesadorOcioso){
+		if(viene_de_modo_usuario()){
+			p_proc_actual->veces_usuario++;
+		}
+		else{
+			p_proc_actual->veces_sistema++;
+		}
+
+		if(p_proc_actual->periodoRT > 0){
+			// Tiempo real: al agotar el presupuesto deja la UCP
+			p_proc_actual->consumidoRT++;
+			if(p_proc_actual->consumidoRT >= p_proc_actual->presupuestoRT){
+				idABloquear = p_proc_actual->id;
+				activar_int_SW();
+			}
+		}
+		else if(politicaPlanificacion == PLAN_STRIDE){
+			// Avanza el paso del proceso en proporcin inversa a sus billetes
+			p_proc_actual->paso += p_proc_actual->zancada;
+		}
+		else if(politicaPlanificacion == PLAN_CFS){
+			// El tiempo virtual avanza igual que el paso de stride
+			p_proc_actual->vruntime += p_proc_actual->zancada;
+		}
+
+		// Carga el tick a la cuota de UCP de su grupo
+		cobrar_cuota(p_proc_actual);
+
+		// Deja la UCP si su grupo se ha terminado, suspendido o ha
+		// agotado su cuota
+		if(p_proc_actual->terminarPendiente || p_proc_actual->suspendido ||
+				cuotas_grupo[p_proc_actual->grupo].estrangulado){
+			idABloquear = p_proc_actual->id;
+			activar_int_SW();
+		}
+
+		// Comprueba si ha terminado rodaja de tiempo del proceso
+		if(p_proc_actual->periodoRT == 0 &&
+				p_proc_actual->ticksRestantesRodaja <= 1){
+			// Si no le queda rodaja activa int SW de planificacion
+			idABloquear = p_proc_actual->id;
+			activar_int_SW();
+		}
+		else{
+			// Resta tick de rodaja al proceso
+			p_proc_actual->ticksRestantesRodaja--;
+		}
+	}
+
+	// El avance del tiempo del sistema lo hace slo el primer procesador
+	if(procesador_actual() == 0){
+		avanzar_reloj();
+	}
+
+	// Expulsa al proceso en ejecucion si hay uno de tiempo real ms urgente
+	if(lista_listos.primero != NULL && !procesadorOcioso &&
+			elegir_proceso() != p_proc_actual){
+		idABloquear = p_proc_actual->id;
+		activar_int_SW();
+	}
+
+	// Publica el nuevo tick y los tiempos de ejecucin
+	actualizar_pagina_datos(p_proc_actual);
+    return;
+}
+
+/*
+ * Tratamiento de llamadas al sistema
+ */
+static void tratar_llamsis(){
+	int nserv, res;
+
+	nserv=leer_registro(0);
+	if (nserv<NSERVICIOS)
+		res=(tabla_servicios[nserv].fservicio)();
+	else
+		res=-1;		/* servicio no existente */
+	escribir_registro(0,res);
+	return;
+}
+
+/*
+ * Tratamiento de interrupciones software
+ */
+static void int_sw(){
+
+	printk("-> TRATANDO INT. SW\n");
+
+	// Interrupcion SW de planificacion
+	// Comprueba que proceso en ejecucin es el que se quiere bloquear
+	if(idABloquear == p_proc_actual->id){
+		comprobar_terminacion();
+
+		// Devuelve el proceso ejecutando a la cola de listos (al final
+		// en round robin, segn su paso en stride)
+		BCP *proceso = lista_listos.primero;
+		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+		eliminar_elem(&lista_listos, proceso);
+		insertar_listo(proceso);
+		fijar_nivel_int(nivel_interrupciones);
+
+		// Cambio de contexto por int sw de planificacin
+		BCP *p_proc_bloqueado = p_proc_actual;
+		p_proc_actual = planificador();
+		cambio_contexto(&(p_proc_bloqueado->contexto_regs), &(p_proc_actual->contexto_regs));
+		comprobar_terminacion();
+	}
+
+	return;
+}
+
+/*
+ *
+ * Funcion auxiliar que rellena el BCP de una tarea nueva, que ejecuta la
+ * imagen desde pc_inicial con el argumento dado, y la pone en la cola de
+ * listos. Usada por crear_tarea y por la llamada crear_hilo.
+ *
+ */
+static void iniciar_tarea(BCP *p_proc, int proc, void *imagen,
+		void *pc_inicial, long argumento){
+	p_proc->info_mem=imagen;
+	p_proc->pila=crear_pila(TAM_PILA);
+	fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
+		pc_inicial,
+		&(p_proc->contexto_regs));
+	p_proc->contexto_regs.registros[1]=argumento;
+	p_proc->id=proc;
+	p_proc->estado=LISTO;
+
+	/* sin mutex ni objetos de sincronizacion abiertos */
+	p_proc->numMutex=0;
+	memset(p_proc->array_mutex_proceso, 0,
+		numMutProc * sizeof(mutex *));
+	p_proc->bloqueadoPorMutex=NULL;
+	p_proc->numObjetos=0;
+	memset(p_proc->array_objetos_proceso, 0,
+		sizeof(p_proc->array_objetos_proceso));
+	p_proc->numEventos=0;
+
+	/* un hilo hereda los descriptores de mutex y objetos del proceso
+	   que lo crea, abriendo cada mutex y objeto una vez ms */
+	if(p_proc_actual != NULL && imagen == p_proc_actual->info_mem){
+		int i;
+		for (i = 0; i < numMutProc; i++){
+			mutex *m = p_proc_actual->array_mutex_proceso[i];
+			if(m != NULL){
+				p_proc->array_mutex_proceso[i] = m;
+				m->procesos[proc] = 1;
+			}
+		}
+		p_proc->numMutex = p_proc_actual->numMutex;
+		for (i = 0; i < NUM_OBJ_PROC; i++){
+			objeto *obj = p_proc_actual->array_objetos_proceso[i];
+			if(obj != NULL){
+				p_proc->array_objetos_proceso[i] = obj;
+				obj->referencias++;
+			}
+		}
+		p_proc->numObjetos = p_proc_actual->numObjetos;
+	}
+
+	/* sin peticiones asincronas */
+	p_proc->ultimoTestigo=0;
+	p_proc->numAsinc=0;
+	p_proc->primeraTerminacion=0;
+	p_proc->numTerminaciones=0;
+	p_proc->esperandoTerminaciones=0;
+
+	p_proc->periodoRT=0;
+	p_proc->fallosPlazo=0;
+
+	/* hereda el grupo del proceso que lo crea; el primero forma
+	   el suyo propio */
+	p_proc->grupo = (p_proc_actual != NULL) ?
+		p_proc_actual->grupo : proc;
+	p_proc->suspendido=0;
+	p_proc->terminarPendiente=0;
+	p_proc->valorSalida=-1;
+	p_proc->bloqueadoPorLectura=0;
+	p_proc->caracterReservado=0;
+	p_proc->bloqueadoCreandoMutex=0;
+
+	/* hereda los billetes del proceso que lo crea */
+	p_proc->billetes = (p_proc_actual != NULL) ?
+		p_proc_actual->billetes : BILLETES_POR_DEFECTO;
+	p_proc->zancada = ZANCADA_BASE / p_proc->billetes;
+	p_proc->paso = pasoGlobal;
+	p_proc->vruntime = vruntimeMinimo;
+	p_proc->enArbolCFS = 0;
+
+	/* empieza en la cola del procesador que lo crea */
+	p_proc->cpu = procesador_actual();
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	/* lo inserta en la cola de listos */
+	insertar_listo(p_proc);
+	fijar_nivel_int(nivel_interrupciones);
+}
+
+/*
+ *
+ * Funcion auxiliar que crea un proceso reservando sus recursos.
+ * Usada por llamada crear_proceso.
+ *
+ */
+static int crear_tarea(char *prog){
+
+	void * imagen, *pc_inicial;
+	int error=0;
+	int proc;
+	BCP *p_proc;
+
+	proc=buscar_BCP_libre();
+	if (proc==-1)
+		return -1;	/* no hay entrada libre */
+
+	/* A rellenar el BCP ... */
+	p_proc=&(tabla_procs[proc]);
+
+	/* crea la imagen de memoria leyendo ejecutable */
+	imagen=crear_imagen(prog, &pc_inicial);
+	if (imagen)
+	{
+		iniciar_tarea(p_proc, proc, imagen, pc_inicial, 0);
+		error= 0;
+	}
+	else
+		error= -1; /* fallo al crear imagen */
+
+	return error;
+}
+
+/*
+ *
+ * Rutinas que llevan a cabo las llamadas al sistema
+ *	sis_crear_proceso sis_escribir
+ *
+ */
+
+/*
+ * Tratamiento de llamada al sistema crear_proceso. Llama a la
+ * funcion auxiliar crear_tarea sis_terminar_proceso
+ */
+int sis_crear_proceso(){
 	char *prog;
 	int res;
 
-	printk("-> PROC %d: CREAR PROCESO\n", p_proc_actual->id);
-	prog=(char *)leer_registro(1);
-	res=crear_tarea(prog);	
+	printk("-> PROC %d: CREAR PROCESO\n", p_proc_actual->id);
+	prog=(char *)leer_registro(1);
+	res=crear_tarea(prog);	
+
+	return res;
+}
+
+/*
+ * Tratamiento de llamada al sistema escribir. Llama simplemente a la
+ * funcion de apoyo escribir_ker
+ */
+int sis_escribir()
+{
+	char *texto;
+	unsigned int longi;
+
+	texto=(char *)leer_registro(1);
+	longi=(unsigned int)leer_registro(2);
+
+	escribir_ker(texto, longi);
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema terminar_proceso. Llama a la
+ * funcion auxiliar liberar_proceso
+ */
+int sis_terminar_proceso(){
+
+	printk("-> FIN PROCESO %d\n", p_proc_actual->id);
+
+	/* valor de terminacin, que recoge esperar_hilo si es un hilo */
+	p_proc_actual->valorSalida = (int)leer_registro(1);
+	liberar_proceso();
+
+        return 0; /* no debera llegar aqui */
+}
+
+/*
+* Funciones adicionales implementadas
+*
+*/
+
+// Devuelve el identificador del proceso que la invoca
+int sis_obtener_id_pr(){
+	return p_proc_actual->id;
+}
+
+// Bloquea el proceso en la lista de bloqueados hasta el tick indicado.
+// El plazo es absoluto, de modo que int_reloj lo compara directamente
+// con numTicks.
+static void dormir_hasta(int fin){
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	p_proc_actual->fin_bloqueo = fin;
+	bloquear_proceso(&lista_bloqueados);
+	fijar_nivel_int(nivel_interrupciones);
+}
+
+// El proceso se queda bloqueado los segundos especificados
+int sis_dormir(){
+	unsigned int numSegundos;
+	numSegundos = (unsigned int)leer_registro(1);
+
+	dormir_hasta(numTicks + numSegundos * ticksPorSegundo);
+
+	return 0;
+}
+
+// El proceso se queda bloqueado los ticks especificados
+int sis_dormir_ticks(){
+	unsigned int ticks = (unsigned int)leer_registro(1);
+
+	dormir_hasta(numTicks + ticks);
+
+	return 0;
+}
+
+// El proceso se queda bloqueado hasta el tick absoluto especificado (el
+// valor que devuelve tiempos_proceso). Si ya ha pasado retorna sin
+// bloquearse, devolviendo 1 para que el proceso detecte el retraso.
+int sis_dormir_hasta(){
+	int fin = (int)leer_registro(1);
+
+	if(fin <= numTicks){
+		return 1;
+	}
+	dormir_hasta(fin);
+
+	return 0;
+}
+
+int sis_tiempos_proceso(){
+
+	struct tiempos_ejec *tiempos_ejecucion;
+
+	// Comprueba si existe argumento
+	tiempos_ejecucion = (struct tiempos_ejec *)leer_registro(1);
+
+	if(tiempos_ejecucion != NULL){
+		// Si hay argumento fija variable global
+		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+		accesoParam = 1;
+		fijar_nivel_int(nivel_interrupciones);
+
+		// Rellena estructura con el tiempo de sistema y tiempo de usuario
+		tiempos_ejecucion->sistema = p_proc_actual->veces_sistema;
+		tiempos_ejecucion->usuario = p_proc_actual->veces_usuario;
+	}
+
+	return numTicks;
+}
+
+int sis_crear_mutex(){
+
+	char *nombre = (char *)leer_registro(1);
+	int tipo = (int)leer_registro(2);
+
+	// Comprueba nmero de mutex del proceso
+	if(p_proc_actual->numMutex >= numMutProc){
+		return -1;
+	}
+
+	// Comprueba tamao de nombre (el vaco marca los mutex libres)
+	if(strlen(nombre) > MAX_NOM_MUT || nombre[0] == '\0'){
+		return -2;
+	}	
+
+	// Comprueba nombre nico de mutex
+	int i;
+	for (i = 0; i < numMut; i++){
+		if(array_mutex[i].nombre[0] != '\0' && 
+			strcmp(array_mutex[i].nombre, nombre) == 0){
+			return -3;
+		}
+	}
+
+	// Compueba nmero de mutex en el sistema
+	while(mutexExistentes == numMut){
+		// Bloquear proceso actual
+		p_proc_actual->estado = BLOQUEADO;
+		p_proc_actual->bloqueadoCreandoMutex = 1;
+		p_proc_actual->listaEspera = &lista_bloqueados;
+
+		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+		eliminar_elem(&lista_listos, p_proc_actual);
+		insertar_ultimo(&lista_bloqueados, p_proc_actual);
+		fijar_nivel_int(nivel_interrupciones);
+
+		// Cambio de contexto voluntario
+		BCP *proceso_bloqueado = p_proc_actual;
+		p_proc_actual = planificador();
+		cambio_contexto(&(proceso_bloqueado->contexto_regs), &(p_proc_actual->contexto_regs));	
+		comprobar_terminacion();
+
+		// Vuelve a activarse y comprueba nombre nico de mutex
+		for (i = 0; i < numMut; i++){
+			if(array_mutex[i].nombre[0] != '\0' && 
+				strcmp(array_mutex[i].nombre, nombre) == 0){
+				return -3;
+			}
+		}
+	}
+
+	// Busca espacio libre para crear nuevo mutex
+	int posMutex;
+	for (i = 0; i < numMut; i++){
+		if(array_mutex[i].nombre[0] == '\0'){
+			mutex *mutexCreado = &(array_mutex[i]);
+			strcpy(mutexCreado->nombre, nombre);
+			mutexCreado->tipo=tipo;
+			mutexCreado->propietario = -1;
+			mutexCreado->numLocks = 0;
+			array_mutex[i].procesos[p_proc_actual->id] = 1;
+			posMutex = i;
+			break;
+		}
+	}
+	
+	mutexExistentes++;
+
+	// Busca descriptor libre para mutex
+	int df = -4; // Descriptor
+	for (i = 0; i < numMutProc; i++){
+		if(p_proc_actual->array_mutex_proceso[i] == NULL){
+			p_proc_actual->array_mutex_proceso[i] = &array_mutex[posMutex];
+			p_proc_actual->numMutex++;
+			df = i;
+			break;
+		}
+	}
+
+	return df;
+}
+
+int sis_abrir_mutex(){
+
+	char *nombre = (char *)leer_registro(1);
+
+	// Comprueba nmero de mutex del proceso
+	if(p_proc_actual->numMutex == numMutProc){
+		return -1;
+	}
+
+	int i;
+	int posMutex = -2;
+
+	for (i = 0; i < numMut; i++){
+		if(array_mutex[i].nombre[0] != '\0' && strcmp(array_mutex[i].nombre, nombre) == 0){
+			// Mutex encontrado
+			array_mutex[i].procesos[p_proc_actual->id] = 1;
+			posMutex = i;
+			break;
+		}
+	}
+
+	if(posMutex == -2){
+		// No existe mutex con ese nombre
+		return -2;
+	}
+
+	// Busca descriptor libre para mutex
+	int df = -4; // Descriptor
+	for (i = 0; i < numMutProc; i++){
+		if(p_proc_actual->array_mutex_proceso[i] == NULL){
+			p_proc_actual->array_mutex_proceso[i] = &array_mutex[posMutex];
+			p_proc_actual->numMutex++;
+			df = i;
+			break;
+		}
+	}
+
+	return df;
+}
+
+int sis_cerrar_mutex(){
+
+	// Descriptor del mutex que se debe cerrar
+	unsigned int mutexId = (unsigned int)leer_registro(1);
+
+	// Comprueba que el mutex existe
+	if(mutexId >= numMutProc || p_proc_actual->array_mutex_proceso[mutexId] == NULL){
+		return -1;
+	}
+
+	// Libera el mutex si lo tiene bloqueado y lo elimina si nadie ms lo usa
+	cerrar_mutex_proceso(mutexId);
+
+	return 0;
+}
+
+int sis_lock(){
+
+	// Descriptor del mutex que se debe bloquear
+	unsigned int mutexId = (unsigned int)leer_registro(1);
+
+	// Comprueba que el mutex existe
+	if(mutexId >= numMutProc || p_proc_actual->array_mutex_proceso[mutexId] == NULL){
+		return -1;
+	}
+
+	mutex *m = p_proc_actual->array_mutex_proceso[mutexId];
+
+	// Comprueba si ya lo tiene bloqueado el propio proceso
+	if(m->numLocks > 0 && m->propietario == p_proc_actual->id){
+		if(m->tipo == NO_RECURSIVO){
+			// Segundo lock sobre mutex no recursivo: interbloqueo
+			return -2;
+		}
+		m->numLocks++;
+		return 0;
+	}
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	if(m->numLocks == 0){
+		// Mutex libre: lo obtiene el proceso actual
+		m->propietario = p_proc_actual->id;
+		m->numLocks = 1;
+	}
+	else{
+		// Bloqueado por otro proceso: espera a que se lo ceda con unlock
+		p_proc_actual->bloqueadoPorMutex = m;
+		p_proc_actual->numLocksPendientes = 1;
+		p_proc_actual->turnoEspera = ++ultimoTurno;
+		bloquear_proceso(&(m->esperando));
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return 0;
+}
+
+int sis_unlock(){
+
+	// Descriptor del mutex que se debe desbloquear
+	unsigned int mutexId = (unsigned int)leer_registro(1);
+
+	// Comprueba que el mutex existe
+	if(mutexId >= numMutProc || p_proc_actual->array_mutex_proceso[mutexId] == NULL){
+		return -1;
+	}
+
+	mutex *m = p_proc_actual->array_mutex_proceso[mutexId];
+
+	// Comprueba que el proceso actual tiene bloqueado el mutex
+	if(m->numLocks == 0 || m->propietario != p_proc_actual->id){
+		return -2;
+	}
+
+	m->numLocks--;
+	if(m->numLocks == 0){
+		// Cede el mutex al primer proceso bloqueado en l
+		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+		liberar_mutex(m);
+		fijar_nivel_int(nivel_interrupciones);
+	}
+
+	return 0;
+}
+
+int sis_leer_caracter(){	
+	while(1){
+		// Se bloquea si no quedan caracteres sin guardar para otros,
+		// salvo que tenga uno guardado
+		if(!p_proc_actual->caracterReservado &&
+				caracteresEnBuffer <= caracteresReservados){
+			p_proc_actual->estado = BLOQUEADO;
+			p_proc_actual->bloqueadoPorLectura = 1;
+			p_proc_actual->turnoEspera = ++ultimoTurno;
+			p_proc_actual->listaEspera = &lista_bloqueados;
+			int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+			eliminar_elem(&lista_listos, p_proc_actual);
+			insertar_ultimo(&lista_bloqueados, p_proc_actual);
+			fijar_nivel_int(nivel_interrupciones);
+
+			nivel_interrupciones = fijar_nivel_int(NIVEL_2);
+			// Cambio de contexto voluntario		
+			BCP *proceso_bloqueado = p_proc_actual;
+			p_proc_actual = planificador();
+			cambio_contexto(&(proceso_bloqueado->contexto_regs), &(p_proc_actual->contexto_regs));
+			fijar_nivel_int(nivel_interrupciones);
+			comprobar_terminacion();
+		}
+		else{
+			// Solicita el primer caracter del buffer
+			soltar_caracter_reservado(p_proc_actual);
+			return (long)sacar_caracter();
+		}
+	}	
+}
+
+/*
+ *
+ * Semaforos y condiciones: objetos de sincronizacion con nombre
+ * accedidos mediante descriptores, igual que los mutex
+ *
+ */
+
+/*
+ * Busca un objeto de un determinado tipo por su nombre
+ */
+static objeto * buscar_objeto(int tipo, char *nombre){
+	int i;
+
+	for (i = 0; i < NUM_OBJ; i++){
+		if(array_objetos[i].tipo == tipo &&
+			strcmp(array_objetos[i].nombre, nombre) == 0){
+			return &(array_objetos[i]);
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Asigna un descriptor libre del proceso actual al objeto
+ */
+static int asignar_descriptor_objeto(objeto *obj){
+	int i;
+
+	for (i = 0; i < NUM_OBJ_PROC; i++){
+		if(p_proc_actual->array_objetos_proceso[i] == NULL){
+			p_proc_actual->array_objetos_proceso[i] = obj;
+			p_proc_actual->numObjetos++;
+			obj->referencias++;
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+ * Crea un objeto con nombre y devuelve un descriptor para l
+ */
+static int crear_objeto(int tipo, char *nombre, objeto **obj){
+	int i;
+
+	// Comprueba nmero de objetos del proceso
+	if(p_proc_actual->numObjetos >= NUM_OBJ_PROC){
+		return -1;
+	}
+
+	// Comprueba longitud de nombre
+	if(strlen(nombre) > MAX_NOM_OBJ){
+		return -2;
+	}
+
+	// Comprueba nombre nico del objeto
+	if(buscar_objeto(tipo, nombre) != NULL){
+		return -3;
+	}
+
+	// Busca espacio libre para el nuevo objeto
+	for (i = 0; i < NUM_OBJ; i++){
+		if(array_objetos[i].tipo == OBJ_LIBRE){
+			*obj = &(array_objetos[i]);
+			(*obj)->tipo = tipo;
+			strcpy((*obj)->nombre, nombre);
+			(*obj)->referencias = 0;
+			(*obj)->valor = 0;
+			(*obj)->esperando.primero = NULL;
+			(*obj)->esperando.ultimo = NULL;
+			(*obj)->memoria = NULL;
+			(*obj)->tam = 0;
+			(*obj)->capacidad = 0;
+			(*obj)->inicio = 0;
+			(*obj)->numMensajes = 0;
+			(*obj)->esperandoEnvio.primero = NULL;
+			(*obj)->esperandoEnvio.ultimo = NULL;
+			(*obj)->periodo = 0;
+			(*obj)->vencimiento = 0;
+			return asignar_descriptor_objeto(*obj);
+		}
+	}
+
+	// No quedan objetos libres en el sistema
+	return -4;
+}
+
+/*
+ * Abre un objeto existente y devuelve un descriptor para l
+ */
+static int abrir_objeto(int tipo, char *nombre){
+	objeto *obj;
+
+	// Comprueba nmero de objetos del proceso
+	if(p_proc_actual->numObjetos >= NUM_OBJ_PROC){
+		return -1;
+	}
+
+	if((obj = buscar_objeto(tipo, nombre)) == NULL){
+		// No existe objeto con ese nombre
+		return -2;
+	}
+
+	return asignar_descriptor_objeto(obj);
+}
+
+/*
+ * Devuelve el objeto asociado a un descriptor del proceso actual o NULL
+ * si el descriptor no es vlido o no corresponde con el tipo indicado
+ */
+static objeto * obtener_objeto(unsigned int desc, int tipo){
+	objeto *obj;
+
+	if(desc >= NUM_OBJ_PROC){
+		return NULL;
+	}
+	obj = p_proc_actual->array_objetos_proceso[desc];
+	if(obj == NULL || obj->tipo != tipo){
+		return NULL;
+	}
+	return obj;
+}
+
+/*
+ * Despierta al primer proceso que espera en la condicion. Si el mutex
+ * asociado est libre se lo cede; si no, lo pasa a la lista de espera del
+ * mutex para que lo reciba en el unlock, evitando que compita por l.
+ */
+static void despertar_condicion(objeto *cond){
+	BCP *proceso = cond->esperando.primero;
+	mutex *m = proceso->bloqueadoPorMutex;
+
+	if(m->numLocks == 0){
+		m->propietario = proceso->id;
+		m->numLocks = proceso->numLocksPendientes;
+		proceso->bloqueadoPorMutex = NULL;
+		desbloquear_proceso(&(cond->esperando));
+	}
+	else{
+		eliminar_primero(&(cond->esperando));
+		proceso->turnoEspera = ++ultimoTurno;
+		proceso->listaEspera = &(m->esperando);
+		insertar_ultimo(&(m->esperando), proceso);
+	}
+}
+
+int sis_crear_semaforo(){
+	char *nombre = (char *)leer_registro(1);
+	int valor = (int)leer_registro(2);
+	objeto *sem;
+	int df;
+
+	// Comprueba valor inicial
+	if(valor < 0){
+		return -5;
+	}
+
+	if((df = crear_objeto(OBJ_SEMAFORO, nombre, &sem)) >= 0){
+		sem->valor = valor;
+	}
+	return df;
+}
+
+int sis_abrir_semaforo(){
+	char *nombre = (char *)leer_registro(1);
+
+	return abrir_objeto(OBJ_SEMAFORO, nombre);
+}
+
+int sis_esperar_semaforo(){
+	unsigned int semId = (unsigned int)leer_registro(1);
+	objeto *sem;
+
+	if((sem = obtener_objeto(semId, OBJ_SEMAFORO)) == NULL){
+		return -1;
+	}
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	if(sem->valor > 0){
+		sem->valor--;
+	}
+	else{
+		// Al despertar ya tiene la unidad que le cede quien seala
+		bloquear_proceso(&(sem->esperando));
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return 0;
+}
+
+int sis_intentar_semaforo(){
+	unsigned int semId = (unsigned int)leer_registro(1);
+	objeto *sem;
+	int res = 0;
+
+	if((sem = obtener_objeto(semId, OBJ_SEMAFORO)) == NULL){
+		return -1;
+	}
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	if(sem->valor > 0){
+		sem->valor--;
+	}
+	else{
+		// Se bloqueara
+		res = -2;
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return res;
+}
+
+int sis_senalar_semaforo(){
+	unsigned int semId = (unsigned int)leer_registro(1);
+	objeto *sem;
+
+	if((sem = obtener_objeto(semId, OBJ_SEMAFORO)) == NULL){
+		return -1;
+	}
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	if(desbloquear_proceso(&(sem->esperando)) == NULL){
+		// No hay procesos esperando: se incrementa el contador
+		sem->valor++;
+		notificar_evento(sem);
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return 0;
+}
+
+int sis_cerrar_semaforo(){
+	unsigned int semId = (unsigned int)leer_registro(1);
+
+	if(obtener_objeto(semId, OBJ_SEMAFORO) == NULL){
+		return -1;
+	}
+	cerrar_objeto_proceso(semId);
+
+	return 0;
+}
+
+int sis_crear_condicion(){
+	char *nombre = (char *)leer_registro(1);
+	objeto *cond;
+
+	return crear_objeto(OBJ_CONDICION, nombre, &cond);
+}
+
+int sis_abrir_condicion(){
+	char *nombre = (char *)leer_registro(1);
+
+	return abrir_objeto(OBJ_CONDICION, nombre);
+}
+
+int sis_esperar_condicion(){
+	unsigned int condId = (unsigned int)leer_registro(1);
+	unsigned int mutexId = (unsigned int)leer_registro(2);
+	objeto *cond;
+	mutex *m;
+
+	if((cond = obtener_objeto(condId, OBJ_CONDICION)) == NULL ||
+		mutexId >= numMutProc ||
+		(m = p_proc_actual->array_mutex_proceso[mutexId]) == NULL){
+		return -1;
+	}
+
+	// El proceso debe tener bloqueado el mutex asociado
+	if(m->numLocks == 0 || m->propietario != p_proc_actual->id){
+		return -2;
+	}
+
+	// Libera el mutex y se bloquea en la condicin de forma atmica
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	p_proc_actual->bloqueadoPorMutex = m;
+	p_proc_actual->numLocksPendientes = m->numLocks;
+	liberar_mutex(m);
+	bloquear_proceso(&(cond->esperando));
+	fijar_nivel_int(nivel_interrupciones);
+
+	// Al despertar vuelve a ser propietario del mutex
+	return 0;
+}
+
+int sis_senalar_condicion(){
+	unsigned int condId = (unsigned int)leer_registro(1);
+	objeto *cond;
+
+	if((cond = obtener_objeto(condId, OBJ_CONDICION)) == NULL){
+		return -1;
+	}
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	if(cond->esperando.primero != NULL){
+		despertar_condicion(cond);
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return 0;
+}
+
+int sis_difundir_condicion(){
+	unsigned int condId = (unsigned int)leer_registro(1);
+	objeto *cond;
+
+	if((cond = obtener_objeto(condId, OBJ_CONDICION)) == NULL){
+		return -1;
+	}
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	while(cond->esperando.primero != NULL){
+		despertar_condicion(cond);
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return 0;
+}
+
+int sis_cerrar_condicion(){
+	unsigned int condId = (unsigned int)leer_registro(1);
+
+	if(obtener_objeto(condId, OBJ_CONDICION) == NULL){
+		return -1;
+	}
+	cerrar_objeto_proceso(condId);
+
+	return 0;
+}
+
+/*
+ *
+ * Futex: colas de espera asociadas a direcciones de usuario, que permiten
+ * a la biblioteca implementar cerrojos que slo entran en el ncleo
+ * cuando hay contencin
+ *
+ */
+
+/*
+ * Devuelve la cola de espera que corresponde a una direccion de usuario
+ */
+static lista_BCPs * cola_futex(int *dir){
+	return &(colas_futex[((unsigned long)dir / sizeof(int)) % NUM_COLAS_FUTEX]);
+}
+
+int sis_futex_esperar(){
+	int *dir = (int *)leer_registro(1);
+	int valor = (int)leer_registro(2);
+	int actual;
+	int res = 0;
+
+	// Comprueba el valor y se bloquea de forma atmica
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	accesoParam = 1;
+	actual = *dir;
+	accesoParam = 0;
+	if(actual != valor){
+		// El valor ya ha cambiado: no se bloquea
+		res = -1;
+	}
+	else{
+		p_proc_actual->futexEsperado = dir;
+		bloquear_proceso(cola_futex(dir));
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return res;
+}
+
+int sis_futex_despertar(){
+	int *dir = (int *)leer_registro(1);
+	int num = (int)leer_registro(2);
+	lista_BCPs *cola = cola_futex(dir);
+	int despertados = 0;
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	BCP *proceso = cola->primero;
+	while(proceso != NULL && despertados < num){
+		BCP *procesoSiguiente = proceso->siguiente;
+
+		// En la misma cola puede haber procesos de otras direcciones
+		if(proceso->futexEsperado == dir){
+			proceso->futexEsperado = NULL;
+			proceso->estado = LISTO;
+			eliminar_elem(cola, proceso);
+			insertar_listo(proceso);
+			despertados++;
+		}
+		proceso = procesoSiguiente;
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return despertados;
+}
+
+/*
+ *
+ * Memoria compartida: segmentos con nombre que los procesos asocian a
+ * su mapa, de manera que pueden intercambiar datos sin copiarlos a
+ * travs del ncleo. Se liberan al cerrarse el ltimo descriptor.
+ *
+ */
+
+/*
+ * Devuelve al proceso la direccion del segmento en el parametro dir
+ */
+static void devolver_dir_memoria(objeto *seg, void **dir){
+	accesoParam = 1;
+	*dir = seg->memoria;
+	accesoParam = 0;
+}
+
+int sis_crear_memoria(){
+	char *nombre = (char *)leer_registro(1);
+	unsigned int tam = (unsigned int)leer_registro(2);
+	void **dir = (void **)leer_registro(3);
+	objeto *seg;
+	void *memoria;
+	int df;
+
+	// Comprueba tamao del segmento
+	if(tam == 0 || tam > MAX_TAM_MEM){
+		return -5;
+	}
+
+	if((memoria = reservar_bloque(tam)) == NULL){
+		return -6;
+	}
+	memset(memoria, 0, tam);
+
+	if((df = crear_objeto(OBJ_MEMORIA, nombre, &seg)) < 0){
+		liberar_bloque(memoria, tam);
+		return df;
+	}
+	seg->memoria = memoria;
+	seg->tam = tam;
+
+	devolver_dir_memoria(seg, dir);
+	return df;
+}
+
+int sis_asociar_memoria(){
+	char *nombre = (char *)leer_registro(1);
+	void **dir = (void **)leer_registro(2);
+	int df;
+
+	if((df = abrir_objeto(OBJ_MEMORIA, nombre)) < 0){
+		return df;
+	}
+
+	devolver_dir_memoria(p_proc_actual->array_objetos_proceso[df], dir);
+	return df;
+}
+
+int sis_desasociar_memoria(){
+	unsigned int memId = (unsigned int)leer_registro(1);
+
+	if(obtener_objeto(memId, OBJ_MEMORIA) == NULL){
+		return -1;
+	}
+	cerrar_objeto_proceso(memId);
+
+	return 0;
+}
+
+/*
+ *
+ * Colas de mensajes: anillo de huecos de tamao fijo con una lista de
+ * espera para los emisores (cola llena) y otra para los receptores
+ * (cola vaca). Cada llamada puede transferir varios mensajes.
+ *
+ */
+
+/*
+ * Copia en la cola los mensajes que quepan de los indicados,
+ * devolviendo cuntos ha copiado
+ */
+static int copiar_a_cola(objeto *cola, char *mensajes, int num){
+	int copiados = 0;
+
+	accesoParam = 1;
+	while(copiados < num && cola->numMensajes < cola->capacidad){
+		int hueco = (cola->inicio + cola->numMensajes) % cola->capacidad;
+		memcpy((char *)cola->memoria + hueco * cola->tam,
+			mensajes + copiados * cola->tam, cola->tam);
+		cola->numMensajes++;
+		copiados++;
+	}
+	accesoParam = 0;
+
+	return copiados;
+}
+
+/*
+ * Extrae de la cola hasta num mensajes, devolviendo cuntos ha extrado
+ */
+static int copiar_de_cola(objeto *cola, char *mensajes, int num){
+	int copiados = 0;
+
+	accesoParam = 1;
+	while(copiados < num && cola->numMensajes > 0){
+		memcpy(mensajes + copiados * cola->tam,
+			(char *)cola->memoria + cola->inicio * cola->tam, cola->tam);
+		cola->inicio = (cola->inicio + 1) % cola->capacidad;
+		cola->numMensajes--;
+		copiados++;
+	}
+	accesoParam = 0;
+
+	return copiados;
+}
+
+/*
+ * Desbloquea hasta num procesos de la lista en orden FIFO
+ */
+static void despertar_procesos(lista_BCPs *lista, int num){
+	while(num > 0 && desbloquear_proceso(lista) != NULL){
+		num--;
+	}
+}
+
+int sis_crear_cola(){
+	char *nombre = (char *)leer_registro(1);
+	int capacidad = (int)leer_registro(2);
+	int tam = (int)leer_registro(3);
+	objeto *cola;
+	void *huecos;
+	int df;
+
+	// Comprueba dimensiones de la cola
+	if(capacidad <= 0 || capacidad > MAX_MENSAJES_COLA ||
+		tam <= 0 || tam > MAX_TAM_MENSAJE){
+		return -5;
+	}
+
+	if((huecos = reservar_bloque(capacidad * tam)) == NULL){
+		return -6;
+	}
+
+	if((df = crear_objeto(OBJ_COLA, nombre, &cola)) < 0){
+		liberar_bloque(huecos, capacidad * tam);
+		return df;
+	}
+	cola->memoria = huecos;
+	cola->capacidad = capacidad;
+	cola->tam = tam;
+
+	return df;
+}
+
+int sis_abrir_cola(){
+	char *nombre = (char *)leer_registro(1);
+
+	return abrir_objeto(OBJ_COLA, nombre);
+}
+
+/*
+ * Enva num mensajes consecutivos. Si es bloqueante espera hasta poder
+ * enviarlos todos; si no, enva slo los que quepan. Devuelve el nmero
+ * de mensajes enviados.
+ */
+int sis_enviar_cola(){
+	unsigned int colaId = (unsigned int)leer_registro(1);
+	char *mensajes = (char *)leer_registro(2);
+	int num = (int)leer_registro(3);
+	int bloqueante = (int)leer_registro(4);
+	objeto *cola;
+	int enviados = 0;
+
+	if((cola = obtener_objeto(colaId, OBJ_COLA)) == NULL || num < 0){
+		return -1;
+	}
+
+	while(enviados < num){
+		int n = copiar_a_cola(cola, mensajes + enviados * cola->tam,
+				num - enviados);
+		enviados += n;
+
+		// Cada mensaje puede satisfacer a un receptor bloqueado
+		despertar_procesos(&(cola->esperando), n);
+		if(n > 0){
+			notificar_evento(cola);
+		}
+
+		if(enviados < num){
+			if(!bloqueante){
+				break;
+			}
+			int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+			if(cola->numMensajes == cola->capacidad){
+				bloquear_proceso(&(cola->esperandoEnvio));
+			}
+			fijar_nivel_int(nivel_interrupciones);
+		}
+	}
+
+	return enviados;
+}
+
+/*
+ * Recibe hasta num mensajes. Si es bloqueante espera hasta que haya al
+ * menos uno; si no, retorna inmediatamente. Devuelve el nmero de
+ * mensajes recibidos.
+ */
+int sis_recibir_cola(){
+	unsigned int colaId = (unsigned int)leer_registro(1);
+	char *mensajes = (char *)leer_registro(2);
+	int num = (int)leer_registro(3);
+	int bloqueante = (int)leer_registro(4);
+	objeto *cola;
+	int recibidos = 0;
+
+	if((cola = obtener_objeto(colaId, OBJ_COLA)) == NULL || num < 0){
+		return -1;
+	}
+
+	while(num > 0){
+		recibidos = copiar_de_cola(cola, mensajes, num);
+
+		// Cada hueco liberado puede satisfacer a un emisor bloqueado
+		despertar_procesos(&(cola->esperandoEnvio), recibidos);
+		if(recibidos > 0){
+			notificar_evento(cola);
+		}
+
+		if(recibidos > 0 || !bloqueante){
+			break;
+		}
+		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+		if(cola->numMensajes == 0){
+			bloquear_proceso(&(cola->esperando));
+		}
+		fijar_nivel_int(nivel_interrupciones);
+	}
+
+	return recibidos;
+}
+
+int sis_cerrar_cola(){
+	unsigned int colaId = (unsigned int)leer_registro(1);
+
+	if(obtener_objeto(colaId, OBJ_COLA) == NULL){
+		return -1;
+	}
+	cerrar_objeto_proceso(colaId);
+
+	return 0;
+}
+
+/*
+ *
+ * Espera de mltiples eventos: el proceso se bloquea una sola vez en
+ * lista_esperando_eventos con la lista de objetos que le interesan y lo
+ * despiertan las operaciones que pueden dejar listo alguno de ellos o el
+ * vencimiento del plazo
+ *
+ */
+
+/*
+ * Obtiene el objeto del kernel al que se refiere un evento del usuario.
+ * Devuelve -1 si el tipo o el descriptor no son vlidos.
+ */
+static int resolver_evento(evento *ev, evento_esperado *esperado){
+	esperado->tipo = ev->tipo;
+
+	switch(ev->tipo){
+	case EV_TERMINAL:
+		esperado->objeto = bufferCaracteres;
+		break;
+	case EV_MUTEX:
+		if(ev->desc >= numMutProc){
+			return -1;
+		}
+		esperado->objeto = p_proc_actual->array_mutex_proceso[ev->desc];
+		break;
+	case EV_SEMAFORO:
+		esperado->objeto = obtener_objeto(ev->desc, OBJ_SEMAFORO);
+		break;
+	case EV_COLA_RECIBIR:
+	case EV_COLA_ENVIAR:
+		esperado->objeto = obtener_objeto(ev->desc, OBJ_COLA);
+		break;
+	case EV_TEMPORIZADOR:
+		esperado->objeto = obtener_objeto(ev->desc, OBJ_TEMPORIZADOR);
+		break;
+	default:
+		return -1;
+	}
+
+	return (esperado->objeto == NULL) ? -1 : 0;
+}
+
+/*
+ * Indica si se ha producido un evento. Los eventos indican estado, no
+ * se consumen: el proceso debe realizar despus la operacin.
+ */
+static int evento_listo(evento_esperado *esperado){
+	mutex *m;
+	objeto *obj;
+
+	switch(esperado->tipo){
+	case EV_TERMINAL:
+		return caracteresEnBuffer > caracteresReservados;
+	case EV_MUTEX:
+		m = (mutex *)esperado->objeto;
+		return m->numLocks == 0;
+	case EV_SEMAFORO:
+		obj = (objeto *)esperado->objeto;
+		return obj->valor > 0;
+	case EV_COLA_RECIBIR:
+		obj = (objeto *)esperado->objeto;
+		return obj->numMensajes > 0;
+	case EV_COLA_ENVIAR:
+		obj = (objeto *)esperado->objeto;
+		return obj->numMensajes < obj->capacidad;
+	case EV_TEMPORIZADOR:
+		obj = (objeto *)esperado->objeto;
+		return numTicks >= obj->vencimiento;
+	}
+	return 0;
+}
+
+/*
+ * Espera a que se produzca alguno de los num eventos o venza el plazo
+ * (en milisegundos, negativo para esperar sin lmite). Marca en el campo
+ * listo de cada evento si se ha producido y devuelve cuntos lo han
+ * hecho (0 si vence el plazo).
+ */
+int sis_esperar_eventos(){
+	evento *eventos = (evento *)leer_registro(1);
+	int num = (int)leer_registro(2);
+	int plazo = (int)leer_registro(3);
+	evento ev[MAX_EVENTOS];
+	evento_esperado esperados[MAX_EVENTOS];
+	int fin = SIN_PLAZO;
+	int listos, i;
+
+	if(num <= 0 || num > MAX_EVENTOS){
+		return -1;
+	}
+
+	accesoParam = 1;
+	memcpy(ev, eventos, num * sizeof(evento));
+	accesoParam = 0;
+
+	for (i = 0; i < num; i++){
+		if(resolver_evento(&ev[i], &esperados[i]) < 0){
+			return -1;
+		}
+	}
+
+	if(plazo >= 0){
+		// Redondea el plazo hacia arriba al siguiente tick
+		fin = numTicks + (plazo * ticksPorSegundo + 999) / 1000;
+	}
+
+	while(1){
+		// Comprueba los eventos y se bloquea de forma atmica
+		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+		listos = 0;
+		for (i = 0; i < num; i++){
+			ev[i].listo = evento_listo(&esperados[i]);
+			listos += ev[i].listo;
+		}
+		if(listos > 0 || (fin != SIN_PLAZO && numTicks >= fin)){
+			fijar_nivel_int(nivel_interrupciones);
+			break;
+		}
+
+		p_proc_actual->numEventos = num;
+		memcpy(p_proc_actual->eventos, esperados,
+			num * sizeof(evento_esperado));
+		p_proc_actual->finEsperaEventos = fin;
+		bloquear_proceso(&lista_esperando_eventos);
+
+		// Ya fuera de la lista: deja de estar registrado en los objetos
+		p_proc_actual->numEventos = 0;
+		fijar_nivel_int(nivel_interrupciones);
+	}
+
+	accesoParam = 1;
+	for (i = 0; i < num; i++){
+		eventos[i].listo = ev[i].listo;
+	}
+	accesoParam = 0;
+
+	return listos;
+}
+
+/*
+ *
+ * Temporizadores peridicos: objetos con nombre que vencen cada cierto
+ * nmero de ticks. Se rearman respecto al vencimiento anterior, por lo
+ * que un bucle que espera en ellos mantiene su frecuencia sin deriva.
+ *
+ */
+
+int sis_crear_temporizador(){
+	char *nombre = (char *)leer_registro(1);
+	int periodo = (int)leer_registro(2);
+	objeto *tmp;
+	int df;
+
+	// Comprueba el periodo
+	if(periodo <= 0){
+		return -5;
+	}
+
+	if((df = crear_objeto(OBJ_TEMPORIZADOR, nombre, &tmp)) >= 0){
+		tmp->periodo = periodo;
+		tmp->vencimiento = numTicks + periodo;
+	}
+	return df;
+}
+
+int sis_abrir_temporizador(){
+	char *nombre = (char *)leer_registro(1);
+
+	return abrir_objeto(OBJ_TEMPORIZADOR, nombre);
+}
+
+/*
+ * Espera al siguiente vencimiento del temporizador y lo rearma. Devuelve
+ * el nmero de vencimientos transcurridos desde la espera anterior, que
+ * es mayor que 1 si el proceso no ha llegado a tiempo.
+ */
+int sis_esperar_temporizador(){
+	unsigned int tmpId = (unsigned int)leer_registro(1);
+	objeto *tmp;
+	int vencimientos;
+
+	if((tmp = obtener_objeto(tmpId, OBJ_TEMPORIZADOR)) == NULL){
+		return -1;
+	}
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	while(numTicks < tmp->vencimiento){
+		bloquear_proceso(&(tmp->esperando));
+	}
+	vencimientos = rearmar_temporizador(tmp);
+	fijar_nivel_int(nivel_interrupciones);
+
+	return vencimientos;
+}
+
+int sis_cerrar_temporizador(){
+	unsigned int tmpId = (unsigned int)leer_registro(1);
+
+	if(obtener_objeto(tmpId, OBJ_TEMPORIZADOR) == NULL){
+		return -1;
+	}
+	cerrar_objeto_proceso(tmpId);
+
+	return 0;
+}
+
+/*
+ *
+ * Planificacin de tiempo real: un proceso declara su periodo y el
+ * presupuesto de UCP que necesita en cada uno. El kernel slo lo admite
+ * si la utilizacin total de los procesos de tiempo real no supera
+ * UTILIZACION_MAX_RT, lo que deja UCP para el resto de procesos.
+ *
+ */
+
+/*
+ * Devuelve la utilizacin en milsimas de UCP reservada por los procesos
+ * de tiempo real, sin contar al proceso actual
+ */
+static int utilizacion_rt(){
+	int i;
+	int utilizacion = 0;
+
+	for (i = 0; i < MAX_PROC; i++){
+		BCP *proceso = &(tabla_procs[i]);
+
+		if(proceso->estado != NO_USADA && proceso->periodoRT > 0 &&
+				proceso != p_proc_actual){
+			utilizacion += (proceso->presupuestoRT * 1000 +
+				proceso->periodoRT - 1) / proceso->periodoRT;
+		}
+	}
+	return utilizacion;
+}
+
+/*
+ * Convierte al proceso actual en un proceso de tiempo real con el
+ * periodo y presupuesto indicados, en ticks. Con periodo 0 vuelve a ser
+ * un proceso normal. Devuelve -1 si los parmetros no son vlidos y -2
+ * si no se admite por falta de UCP.
+ */
+int sis_fijar_tiempo_real(){
+	int periodo = (int)leer_registro(1);
+	int presupuesto = (int)leer_registro(2);
+
+	if(periodo == 0){
+		p_proc_actual->periodoRT = 0;
+		return 0;
+	}
+
+	if(periodo < 0 || presupuesto <= 0 || presupuesto > periodo){
+		return -1;
+	}
+
+	// Control de admisin
+	if(utilizacion_rt() + (presupuesto * 1000 + periodo - 1) / periodo >
+			UTILIZACION_MAX_RT){
+		return -2;
+	}
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	p_proc_actual->periodoRT = periodo;
+	p_proc_actual->presupuestoRT = presupuesto;
+	p_proc_actual->plazoRT = numTicks + periodo;
+	p_proc_actual->consumidoRT = 0;
+	p_proc_actual->trabajoTerminado = 0;
+	p_proc_actual->fallosPlazo = 0;
+	fijar_nivel_int(nivel_interrupciones);
+
+	return 0;
+}
+
+/*
+ * Termina el trabajo del periodo actual y espera al comienzo del
+ * siguiente. Devuelve el nmero de plazos incumplidos hasta ahora.
+ */
+int sis_esperar_periodo(){
+	if(p_proc_actual->periodoRT == 0){
+		return -1;
+	}
+
+	p_proc_actual->trabajoTerminado = 1;
+	dormir_hasta(p_proc_actual->plazoRT);
 
-	return res;
+	return p_proc_actual->fallosPlazo;
 }
 
 /*
- * Tratamiento de llamada al sistema escribir. Llama simplemente a la
- * funcion de apoyo escribir_ker
+ *
+ * Planificacin proporcional (stride): cada proceso recibe UCP en
+ * proporcin a sus billetes. Su paso avanza con cada tick de UCP en
+ * ZANCADA_BASE / billetes y se ejecuta el de menor paso.
+ *
  */
-int sis_escribir()
-{
-	char *texto;
-	unsigned int longi;
 
-	texto=(char *)leer_registro(1);
-	longi=(unsigned int)leer_registro(2);
+/*
+ * Fija la poltica de planificacin de los procesos que no son de
+ * tiempo real. Devuelve la poltica anterior o -1 si no es vlida.
+ */
+int sis_fijar_planificacion(){
+	int politica = (int)leer_registro(1);
+	int anterior = politicaPlanificacion;
+	int i;
+
+	if(politica != PLAN_RR && politica != PLAN_STRIDE &&
+			politica != PLAN_CFS){
+		return -1;
+	}
+
+	// Stride y CFS mantienen una nica cola ordenada
+	if(numProcesadores > 1 && politica != PLAN_RR){
+		return -1;
+	}
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	if(politica == PLAN_STRIDE && anterior != PLAN_STRIDE){
+		// Todos los procesos empiezan a competir desde el mismo paso
+		for (i = 0; i < MAX_PROC; i++){
+			tabla_procs[i].paso = 0;
+		}
+		pasoGlobal = 0;
+	}
+	if(anterior == PLAN_CFS && politica != PLAN_CFS){
+		// Vaca el rbol de CFS
+		for (i = 0; i < MAX_PROC; i++){
+			tabla_procs[i].enArbolCFS = 0;
+		}
+		arbol_cfs = NULL;
+		pesoArbolCFS = 0;
+	}
+	politicaPlanificacion = politica;
+	if(politica == PLAN_CFS && anterior != PLAN_CFS){
+		// Todos empiezan desde el mismo tiempo virtual y los listos que
+		// no estn en ejecucin pasan al rbol
+		for (i = 0; i < MAX_PROC; i++){
+			tabla_procs[i].vruntime = 0;
+		}
+		vruntimeMinimo = 0;
+		BCP *proceso;
+		for (proceso = lista_listos.primero; proceso != NULL;
+				proceso = proceso->siguiente){
+			if(proceso != p_proc_actual && proceso->periodoRT == 0){
+				encolar_cfs(proceso);
+			}
+		}
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return anterior;
+}
+
+/*
+ * Fija los billetes del proceso actual, que heredarn los procesos que
+ * cree. Con 0 slo los consulta. Devuelve los billetes anteriores o -1
+ * si el nmero no es vlido.
+ */
+int sis_fijar_billetes(){
+	int billetes = (int)leer_registro(1);
+	int anteriores = p_proc_actual->billetes;
+
+	if(billetes < 0 || billetes > MAX_BILLETES){
+		return -1;
+	}
+
+	if(billetes > 0){
+		p_proc_actual->billetes = billetes;
+		p_proc_actual->zancada = ZANCADA_BASE / billetes;
+	}
+	return anteriores;
+}
+
+/*
+ * Devuelve en el parmetro la direccin de la pgina de datos, que el
+ * proceso puede leer pero no modificar. Devuelve -1 si no la hay.
+ */
+int sis_obtener_pagina_datos(){
+	void **dir = (void **)leer_registro(1);
+
+	if(paginaDatosUsuario == NULL){
+		return -1;
+	}
+
+	accesoParam = 1;
+	*dir = paginaDatosUsuario;
+	accesoParam = 0;
+	return 0;
+}
+
+/*
+ * Ejecuta las peticiones pendientes del anillo del proceso, en orden y a
+ * travs de tabla_servicios, como si las hubiera hecho una a una: cada
+ * servicio lee sus parmetros de los registros y puede bloquear al
+ * proceso. El resultado de cada una se aade al anillo de terminaciones;
+ * si ste se llena, las restantes quedan pendientes. Devuelve el nmero
+ * de peticiones ejecutadas o -1 si el anillo no es vlido.
+ */
+int sis_procesar_lote(){
+	anillo_llamadas *anillo = (anillo_llamadas *)leer_registro(1);
+	unsigned int cab, cola, cab_term, cola_term;
+	peticion_lote peticion;
+	terminacion_lote *terminacion;
+	int procesadas = 0;
+	int i, res;
+
+	for(;;){
+		// Se vuelve a leer el anillo tras cada servicio, que puede
+		// haber bloqueado al proceso
+		accesoParam = 1;
+		cab = anillo->cab_peticiones;
+		cola = __atomic_load_n(&anillo->cola_peticiones, __ATOMIC_ACQUIRE);
+		cab_term = __atomic_load_n(&anillo->cab_terminaciones, __ATOMIC_ACQUIRE);
+		cola_term = anillo->cola_terminaciones;
+		if(cola - cab > TAM_ANILLO || cola_term - cab_term > TAM_ANILLO){
+			accesoParam = 0;
+			return -1;
+		}
+		if(cab == cola || cola_term - cab_term == TAM_ANILLO){
+			accesoParam = 0;
+			break;
+		}
+
+		// La peticin se da por consumida antes de ejecutarla, ya que
+		// el servicio puede no volver (terminar_proceso)
+		peticion = anillo->peticiones[cab % TAM_ANILLO];
+		__atomic_store_n(&anillo->cab_peticiones, cab + 1, __ATOMIC_RELEASE);
+		accesoParam = 0;
+
+		if(peticion.servicio < 0 || peticion.servicio >= NSERVICIOS ||
+				peticion.servicio == PROCESAR_LOTE){
+			res = -1;
+		}
+		else{
+			escribir_registro(0, peticion.servicio);
+			for(i = 1; i < NREGS; i++){
+				escribir_registro(i, peticion.param[i - 1]);
+			}
+			res = (tabla_servicios[peticion.servicio].fservicio)();
+		}
+
+		accesoParam = 1;
+		terminacion = &(anillo->terminaciones[cola_term % TAM_ANILLO]);
+		terminacion->dato = peticion.dato;
+		terminacion->resultado = res;
+		__atomic_store_n(&anillo->cola_terminaciones, cola_term + 1, __ATOMIC_RELEASE);
+		accesoParam = 0;
+		procesadas++;
+	}
+
+	return procesadas;
+}
+
+/*
+ *
+ * Llamadas asncronas: variantes de dormir, leer_caracter y lock que no
+ * bloquean al proceso. Devuelven un testigo y, cuando la operacin se
+ * completa, el kernel deja el testigo y el resultado en la cola de
+ * terminaciones del proceso, que las recoge con esperar_terminaciones.
+ * Las esperas se atienden por orden de llegada junto con las sncronas.
+ *
+ */
+
+int sis_dormir_asinc(){
+	unsigned int numSegundos = (unsigned int)leer_registro(1);
+	peticion_asinc *pet;
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	if((pet = nueva_asinc(ASINC_DORMIR)) == NULL){
+		fijar_nivel_int(nivel_interrupciones);
+		return -1;
+	}
+	pet->fin = numTicks + numSegundos * ticksPorSegundo;
+	fijar_nivel_int(nivel_interrupciones);
+
+	return pet->testigo;
+}
+
+int sis_leer_caracter_asinc(){
+	peticion_asinc *pet;
+	int testigo;
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	if((pet = nueva_asinc(ASINC_LEER)) == NULL){
+		fijar_nivel_int(nivel_interrupciones);
+		return -1;
+	}
+	testigo = pet->testigo;
+
+	// Si hay caracteres que no se han guardado para lectores ya
+	// despertados y nadie espera antes, se completa en el acto
+	if(caracteresEnBuffer > caracteresReservados &&
+			primera_asinc(ASINC_LEER, NULL) == pet){
+		completar_asinc(pet, (long)sacar_caracter());
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return testigo;
+}
+
+int sis_lock_asinc(){
+	unsigned int mutexId = (unsigned int)leer_registro(1);
+	peticion_asinc *pet;
+	int testigo;
+
+	// Comprueba que el mutex existe
+	if(mutexId >= numMutProc || p_proc_actual->array_mutex_proceso[mutexId] == NULL){
+		return -1;
+	}
+
+	mutex *m = p_proc_actual->array_mutex_proceso[mutexId];
+
+	// Segundo lock sobre mutex no recursivo (o pendiente): interbloqueo
+	if(m->tipo == NO_RECURSIVO &&
+			((m->numLocks > 0 && m->propietario == p_proc_actual->id) ||
+			lock_asinc_pendiente(m))){
+		return -2;
+	}
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	if((pet = nueva_asinc(ASINC_LOCK)) == NULL){
+		fijar_nivel_int(nivel_interrupciones);
+		return -1;
+	}
+	testigo = pet->testigo;
+	pet->m = m;
+
+	if(m->numLocks > 0 && m->propietario == p_proc_actual->id){
+		// Mutex recursivo del propio proceso
+		m->numLocks++;
+		completar_asinc(pet, 0);
+	}
+	else if(m->numLocks == 0){
+		// Mutex libre: lo obtiene en el acto
+		m->propietario = p_proc_actual->id;
+		m->numLocks = 1;
+		completar_asinc(pet, 0);
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	return testigo;
+}
+
+/*
+ * Copia en el vector del proceso hasta num terminaciones, las ms
+ * antiguas primero, y devuelve cuntas. Si no hay ninguna y se pide
+ * espera bloqueante, espera a la primera, salvo que no quede ninguna
+ * peticin pendiente.
+ */
+int sis_esperar_terminaciones(){
+	terminacion_asinc *terminaciones = (terminacion_asinc *)leer_registro(1);
+	int num = (int)leer_registro(2);
+	int bloqueante = (int)leer_registro(3);
+	terminacion_asinc copia[MAX_ASINC_PROC];
+	int n, i;
+
+	if(num <= 0){
+		return -1;
+	}
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	while(p_proc_actual->numTerminaciones == 0 && bloqueante &&
+			p_proc_actual->numAsinc > 0){
+		p_proc_actual->esperandoTerminaciones = 1;
+		bloquear_proceso(&lista_esperando_terminaciones);
+	}
+
+	n = p_proc_actual->numTerminaciones;
+	if(n > num){
+		n = num;
+	}
+	for (i = 0; i < n; i++){
+		copia[i] = p_proc_actual->terminaciones[p_proc_actual->primeraTerminacion];
+		p_proc_actual->primeraTerminacion =
+			(p_proc_actual->primeraTerminacion + 1) % MAX_ASINC_PROC;
+	}
+	p_proc_actual->numTerminaciones -= n;
+	p_proc_actual->numAsinc -= n;
+	fijar_nivel_int(nivel_interrupciones);
+
+	accesoParam = 1;
+	memcpy(terminaciones, copia, n * sizeof(terminacion_asinc));
+	accesoParam = 0;
+
+	return n;
+}
+
+/*
+ * Devuelve en el parmetro el uso de la arena y de cada cache de bloques
+ */
+int sis_obtener_estad_memoria(){
+	estad_memoria *estad = (estad_memoria *)leer_registro(1);
+	estad_memoria copia;
+	int i;
+
+	copia.tam_arena = tamArena;
+	copia.usado_arena = usadoArena;
+	copia.tam_heap = tamHeapCaches;
+	copia.num_caches = NUM_CACHES;
+	for (i = 0; i < NUM_CACHES; i++){
+		copia.caches[i].tam_bloque = caches[i].tamBloque;
+		copia.caches[i].bloques = caches[i].bloques;
+		copia.caches[i].usados = caches[i].usados;
+		copia.caches[i].max_usados = caches[i].maxUsados;
+		copia.caches[i].reservas = caches[i].reservas;
+		copia.caches[i].fallos = caches[i].fallos;
+	}
+
+	accesoParam = 1;
+	*estad = copia;
+	accesoParam = 0;
+	return 0;
+}
+
+/*
+ *
+ * Grupos de procesos
+ *	sacar_de_colas en_otro_procesador diferir_terminacion suspender
+ *	reanudar terminar_procesos
+ *
+ */
+
+/*
+ * Saca de su cola a un proceso que no est en ejecucin: la de listos de
+ * su procesador (y el rbol de CFS) o aqulla en la que est bloqueado
+ */
+static void sacar_de_colas(BCP *proceso){
+	if(proceso->estado == LISTO){
+		eliminar_elem(&(procesadores[proceso->cpu].listos), proceso);
+		if(proceso->enArbolCFS){
+			desencolar_cfs(proceso);
+		}
+	}
+	else{
+		eliminar_elem(proceso->listaEspera, proceso);
+	}
+}
+
+/*
+ * Indica si otro procesador est ejecutando el proceso o parado sobre su
+ * pila, de modo que no se puede liberar desde ste
+ */
+static int en_otro_procesador(BCP *proceso){
+	int i;
+
+	for (i = 0; i < numProcesadores; i++){
+		if(i != procesador_actual() && procesadores[i].proc_actual == proceso){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Marca para terminar a un proceso en uso por otro procesador y, si est
+ * bloqueado, lo despierta para que termine en cuanto vuelva a ejecutar
+ */
+static void diferir_terminacion(BCP *proceso){
+	proceso->terminarPendiente = 1;
+	proceso->suspendido = 0;
+	if(proceso->estado == BLOQUEADO){
+		eliminar_elem(proceso->listaEspera, proceso);
+		proceso->bloqueadoPorLectura = 0;
+		proceso->bloqueadoCreandoMutex = 0;
+		proceso->esperandoTerminaciones = 0;
+		proceso->estado = LISTO;
+		insertar_listo(proceso);
+	}
+}
+
+/*
+ * Suspende un proceso. Si est listo pasa ya a la cola de suspendidos; si
+ * est bloqueado lo har al despertar y, si ejecuta en otro procesador,
+ * al tratar su siguiente tick.
+ */
+static void suspender(BCP *proceso){
+	proceso->suspendido = 1;
+	if(proceso->estado == LISTO && !en_otro_procesador(proceso)){
+		sacar_de_colas(proceso);
+		insertar_listo(proceso);
+	}
+}
+
+/*
+ * Reanuda un proceso, devolvindolo a los listos si estaba suspendido
+ */
+static void reanudar(BCP *proceso){
+	proceso->suspendido = 0;
+	if(proceso->estado == BLOQUEADO &&
+			proceso->listaEspera == &lista_suspendidos){
+		eliminar_elem(&lista_suspendidos, proceso);
+		proceso->estado = LISTO;
+		insertar_listo(proceso);
+	}
+}
+
+/*
+ * Termina de una vez los procesos marcados en victima, ninguno de ellos
+ * en uso por un procesador. En lugar de repetir para cada uno lo que hace
+ * liberar_proceso, recorre una sola vez las peticiones asncronas y los
+ * mutex: cede los que tenan bloqueados y elimina los que ya no tiene
+ * abiertos nadie, despertando una sola vez a quien esperaba para crearlos.
+ */
+static void terminar_procesos(int victima[]){
+	int i, k, eliminados = 0;
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+
+	// Fuera de sus colas ya nadie los despierta ni les cede un mutex, y
+	// los caracteres que tuvieran guardados quedan para otros
+	for (i = 0; i < MAX_PROC; i++){
+		if(victima[i]){
+			sacar_de_colas(&(tabla_procs[i]));
+			soltar_caracter_reservado(&(tabla_procs[i]));
+		}
+	}
+
+	// Descarta sus peticiones asncronas pendientes
+	for (i = 0; i < MAX_ASINC; i++){
+		if(array_asinc[i].tipo != ASINC_LIBRE &&
+				victima[array_asinc[i].proceso->id]){
+			array_asinc[i].tipo = ASINC_LIBRE;
+		}
+	}
+
+	// Cierra sus mutex
+	for (i = 0; i < numMut; i++){
+		mutex *m = &(array_mutex[i]);
+		int abierto = 0;
+
+		if(m->nombre[0] == '\0'){
+			continue;
+		}
+		if(m->numLocks > 0 && victima[m->propietario]){
+			liberar_mutex(m);
+		}
+		for (k = 0; k < MAX_PROC; k++){
+			if(victima[k]){
+				m->procesos[k] = 0;
+			}
+			abierto |= m->procesos[k];
+		}
+		if(!abierto){
+			mutexExistentes--;
+			m->nombre[0] = '\0';
+			eliminados++;
+		}
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	if(eliminados > 0){
+		despertar_creadores_mutex();
+	}
+
+	// Cierra sus dems objetos y libera su imagen y su pila
+	for (i = 0; i < MAX_PROC; i++){
+		BCP *proceso = &(tabla_procs[i]);
+
+		if(!victima[i]){
+			continue;
+		}
+		for (k = 0; k < NUM_OBJ_PROC; k++){
+			if(proceso->array_objetos_proceso[k] != NULL){
+				soltar_objeto(proceso->array_objetos_proceso[k]);
+			}
+		}
+		printk("-> FIN PROCESO %d\n", proceso->id);
+		proceso->estado = TERMINADO;
+		soltar_imagen(proceso);
+		liberar_pila(proceso->pila);
+	}
+}
+
+/*
+ * Hace al proceso actual cabeza de un grupo nuevo, al que pertenecern
+ * los procesos que cree a partir de ahora. Devuelve el id del grupo o -1
+ * si otros procesos siguen en el grupo que lleva su id.
+ */
+int sis_crear_grupo(){
+	int i;
+
+	for (i = 0; i < MAX_PROC; i++){
+		if(tabla_procs[i].estado != NO_USADA && &(tabla_procs[i]) != p_proc_actual &&
+				tabla_procs[i].grupo == p_proc_actual->id){
+			return -1;
+		}
+	}
+	p_proc_actual->grupo = p_proc_actual->id;
+	memset(&(cuotas_grupo[p_proc_actual->grupo]), 0, sizeof(cuota_grupo));
+	return p_proc_actual->grupo;
+}
+
+/*
+ * Termina, suspende o reanuda todos los procesos de un grupo. Devuelve
+ * cuntos procesos tiene el grupo o -1 si est vaco o la accin no es
+ * vlida. Si el proceso actual es del grupo, se le aplica al final.
+ */
+int sis_senalar_grupo(){
+	int grupo = (int)leer_registro(1);
+	int accion = (int)leer_registro(2);
+	int victima[MAX_PROC];
+	int i, n = 0, propio = 0;
+
+	if(accion != GRUPO_TERMINAR && accion != GRUPO_SUSPENDER &&
+			accion != GRUPO_REANUDAR){
+		return -1;
+	}
+
+	printk("-> PROC %d: SENALAR GRUPO %d (%d)\n", p_proc_actual->id,
+		grupo, accion);
+
+	memset(victima, 0, sizeof(victima));
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	for (i = 0; i < MAX_PROC; i++){
+		BCP *proceso = &(tabla_procs[i]);
+
+		if(proceso->estado == NO_USADA || proceso->grupo != grupo ||
+				proceso->terminarPendiente){
+			continue;
+		}
+		n++;
+		if(proceso == p_proc_actual){
+			propio = 1;
+		}
+		else if(accion == GRUPO_TERMINAR){
+			if(en_otro_procesador(proceso)){
+				diferir_terminacion(proceso);
+			}
+			else{
+				victima[i] = 1;
+			}
+		}
+		else if(accion == GRUPO_SUSPENDER){
+			suspender(proceso);
+		}
+		else{
+			reanudar(proceso);
+		}
+	}
+	fijar_nivel_int(nivel_interrupciones);
+
+	if(n == 0){
+		return -1;
+	}
+	if(accion == GRUPO_TERMINAR){
+		terminar_procesos(victima);
+	}
+
+	if(propio && accion == GRUPO_TERMINAR){
+		printk("-> FIN PROCESO %d\n", p_proc_actual->id);
+		liberar_proceso();
+	}
+	else if(propio && accion == GRUPO_SUSPENDER){
+		nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+		p_proc_actual->suspendido = 1;
+		bloquear_proceso(&lista_suspendidos);
+		fijar_nivel_int(nivel_interrupciones);
+	}
+	return n;
+}
+
+/*
+ * Fija la cuota de UCP de un grupo: entre todos sus procesos pueden
+ * ejecutar cuota ticks de cada periodo. Con cuota 0 deja de tener lmite.
+ * Devuelve -1 si el grupo est vaco o la cuota o el periodo no son
+ * vlidos.
+ */
+int sis_fijar_cuota_grupo(){
+	int grupo = (int)leer_registro(1);
+	int cuota = (int)leer_registro(2);
+	int periodo = (int)leer_registro(3);
+	int i, miembros = 0;
+
+	if(grupo < 0 || grupo >= MAX_PROC || cuota < 0 ||
+			(cuota > 0 && periodo <= 0)){
+		return -1;
+	}
+	for (i = 0; i < MAX_PROC; i++){
+		if(tabla_procs[i].estado != NO_USADA && tabla_procs[i].grupo == grupo){
+			miembros++;
+		}
+	}
+	if(miembros == 0){
+		return -1;
+	}
+
+	printk("-> PROC %d: CUOTA GRUPO %d: %d DE %d TICKS\n",
+		p_proc_actual->id, grupo, cuota, periodo);
+
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	cuota_grupo *c = &(cuotas_grupo[grupo]);
+	c->cuota = cuota;
+	c->periodo = periodo;
+	c->inicioPeriodo = numTicks;
+	c->consumido = 0;
+	c->total = 0;
+	c->vecesEstrangulado = 0;
+	c->ticksEstrangulado = 0;
+	if(c->estrangulado){
+		liberar_estrangulados(grupo);
+	}
+	fijar_nivel_int(nivel_interrupciones);
 
-	escribir_ker(texto, longi);
 	return 0;
 }
 
 /*
- * Tratamiento de llamada al sistema terminar_proceso. Llama a la
- * funcion auxiliar liberar_proceso
+ * Devuelve en el parmetro la cuota de UCP de un grupo y sus contadores
  */
-int sis_terminar_proceso(){
+int sis_obtener_estad_cuota(){
+	int grupo = (int)leer_registro(1);
+	estad_cuota *estad = (estad_cuota *)leer_registro(2);
+	estad_cuota copia;
 
-	printk("-> FIN PROCESO %d\n", p_proc_actual->id);
+	if(grupo < 0 || grupo >= MAX_PROC){
+		return -1;
+	}
 
-	liberar_proceso();
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	cuota_grupo *c = &(cuotas_grupo[grupo]);
+	copia.cuota = c->cuota;
+	copia.periodo = c->periodo;
+	copia.consumido = c->consumido;
+	copia.total = c->total;
+	copia.estrangulado = c->estrangulado;
+	copia.veces_estrangulado = c->vecesEstrangulado;
+	copia.ticks_estrangulado = c->ticksEstrangulado;
+	fijar_nivel_int(nivel_interrupciones);
 
-        return 0; /* no debera llegar aqui */
+	accesoParam = 1;
+	*estad = copia;
+	accesoParam = 0;
+	return 0;
 }
 
 /*
-* Funciones adicionales implementadas
-*
-*/
-
-// Devuelve el identificador del proceso que la invoca
-int sis_obtener_id_pr(){
-	return p_proc_actual->id;
-}
-
-// El proceso se queda bloqueado los segundos especificados
-int sis_dormir(){
-	unsigned int numSegundos;
-	int nivel_interrupciones;
-	numSegundos = (unsigned int)leer_registro(1);
-
-	// actualiza BCP con el num de segundos y cambia estado a bloqueado
-	p_proc_actual->estado = BLOQUEADO;
-	p_proc_actual->inicio_bloqueo = numTicks;
-	p_proc_actual->secs_bloqueo = numSegundos;	
-
-	// Guarda el nivel anterior de interrupcion y lo fija a 3
-	nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-	
-	// 1. Saca de la lista de procesos listos el BCP del proceso
-	eliminar_elem(&lista_listos, p_proc_actual);
-
-	// 2. Inserta el BCP del proceso en la lista de bloqueados
-	insertar_ultimo(&lista_bloqueados, p_proc_actual);
+ * Devuelve en el parmetro las cargas medias y la presin sobre la UCP,
+ * en milsimas, para que se pueda dejar de lanzar procesos cuando el
+ * sistema est saturado
+ */
+int sis_obtener_estad_carga(){
+	estad_carga *estad = (estad_carga *)leer_registro(1);
+	estad_carga copia;
+	int i;
 
-	// Restaura el nivel de interrupcion anterior
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	for (i = 0; i < NUM_MEDIAS_CARGA; i++){
+		copia.carga[i] = (cargaMedia[i] * 1000) >> BITS_CARGA;
+		copia.presion[i] = (presionMedia[i] * 1000) >> BITS_CARGA;
+	}
+	contar_activos(&copia.ejecutables, &copia.bloqueados);
+	copia.ticks_presion = ticksPresion;
+	copia.ticks = numTicks;
 	fijar_nivel_int(nivel_interrupciones);
 
-	// Cambio de contexto voluntario
-	BCP *p_proc_dormido = p_proc_actual;
-	p_proc_actual = planificador();
-	cambio_contexto(&(p_proc_dormido->contexto_regs), &(p_proc_actual->contexto_regs));
-
+	accesoParam = 1;
+	*estad = copia;
+	accesoParam = 0;
 	return 0;
 }
 
-int sis_tiempos_proceso(){
-
-	struct tiempos_ejec *tiempos_ejecucion;
-
-	// Comprueba si existe argumento
-	tiempos_ejecucion = (struct tiempos_ejec *)leer_registro(1);
+/*
+ *
+ * Parmetros del kernel
+ *	buscar_parametro aplicar_parametro copiar_nombre_parametro
+ *	recortar_blancos leer_configuracion reservar_tablas
+ *
+ */
 
-	if(tiempos_ejecucion != NULL){
-		// Si hay argumento fija variable global
-		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-		accesoParam = 1;
-		fijar_nivel_int(nivel_interrupciones);
+/*
+ * Devuelve la entrada del registro de un parmetro o NULL si no existe
+ */
+static parametro * buscar_parametro(char *nombre){
+	int i;
 
-		// Rellena estructura con el tiempo de sistema y tiempo de usuario
-		tiempos_ejecucion->sistema = p_proc_actual->veces_sistema;
-		tiempos_ejecucion->usuario = p_proc_actual->veces_usuario;
+	for (i = 0; i < NUM_PARAMETROS; i++){
+		if(strcmp(tabla_parametros[i].nombre, nombre) == 0){
+			return &(tabla_parametros[i]);
+		}
 	}
-
-	return numTicks;
+	return NULL;
 }
 
-int sis_crear_mutex(){
-
-	char *nombre = (char *)leer_registro(1);
-	int tipo = (int)leer_registro(2);
+/*
+ * Da un valor a un parmetro. Los que dimensionan estructuras slo se
+ * pueden cambiar al arrancar. Devuelve 0, -1 si el parmetro no existe,
+ * -2 si el valor est fuera de rango o -3 si ya no se puede cambiar.
+ */
+static int aplicar_parametro(char *nombre, int valor, int arrancando){
+	parametro *par = buscar_parametro(nombre);
 
-	// Comprueba nmero de mutex del proceso
-	if(p_proc_actual->numMutex >= NUM_MUT_PROC){
+	if(par == NULL){
 		return -1;
 	}
-
-	// Comprueba tamao de nombre
-	if(strlen(nombre) > MAX_NOM_MUT){
+	if(valor < par->minimo || valor > par->maximo){
 		return -2;
-	}	
+	}
+	if(par->soloArranque && !arrancando){
+		return -3;
+	}
+	*(par->valor) = valor;
+	return 0;
+}
 
-	// Comprueba nombre nico de mutex
+/*
+ * Copia del proceso actual el nombre de un parmetro. Devuelve -1 si es
+ * demasiado largo.
+ */
+static int copiar_nombre_parametro(char *nombre, char *copia){
 	int i;
-	for (i = 0; i < NUM_MUT; i++){
-		if(array_mutex[i].nombre != NULL && 
-			strcmp(array_mutex[i].nombre, nombre) == 0){
-			return -3;
-		}
+
+	accesoParam = 1;
+	for (i = 0; i <= MAX_NOM_PARAM && nombre[i] != '\0'; i++){
+		copia[i] = nombre[i];
 	}
+	accesoParam = 0;
 
-	// Compueba nmero de mutex en el sistema
-	while(mutexExistentes == NUM_MUT){
-		// Bloquear proceso actual
-		p_proc_actual->estado = BLOQUEADO;
-		p_proc_actual->bloqueadoCreandoMutex = 1;
+	if(i > MAX_NOM_PARAM){
+		return -1;
+	}
+	copia[i] = '\0';
+	return 0;
+}
 
-		int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-		eliminar_elem(&lista_listos, p_proc_actual);
-		insertar_ultimo(&lista_bloqueados, p_proc_actual);
-		fijar_nivel_int(nivel_interrupciones);
+/*
+ * Quita los espacios, tabuladores y retornos de carro de los extremos de
+ * la cadena, que se modifica. Devuelve su nuevo comienzo.
+ */
+static char * recortar_blancos(char *cadena){
+	char *fin;
 
-		// Cambio de contexto voluntario
-		BCP *proceso_bloqueado = p_proc_actual;
-		p_proc_actual = planificador();
-		cambio_contexto(&(proceso_bloqueado->contexto_regs), &(p_proc_actual->contexto_regs));	
+	while(*cadena == ' ' || *cadena == '\t' || *cadena == '\r'){
+		cadena++;
+	}
+	fin = cadena + strlen(cadena);
+	while(fin > cadena && (fin[-1] == ' ' || fin[-1] == '\t' ||
+			fin[-1] == '\r')){
+		*--fin = '\0';
+	}
+	return cadena;
+}
 
-		// Vuelve a activarse y comprueba nombre nico de mutex
-		for (i = 0; i < NUM_MUT; i++){
-			if(array_mutex[i].nombre != NULL && 
-				strcmp(array_mutex[i].nombre, nombre) == 0){
-				return -3;
-			}
-		}
+/*
+ * Aplica el fichero de configuracin del arranque, que tiene una lnea
+ * "nombre=valor" por parmetro, con blancos opcionales alrededor de
+ * ambos. Se saltan las lneas vacas y las que empiezan por #. El valor
+ * debe ser un nmero entero completo.
+ */
+static void leer_configuracion(){
+	static char texto[TAM_CONFIG + 1];
+	char *linea, *siguiente, *igual, *valor, *fin;
+	long numero;
+	int n;
+
+	if((n = leer_config_arranque(texto, TAM_CONFIG)) <= 0){
+		return;
 	}
+	texto[n] = '\0';
 
-	// Busca espacio libre para crear nuevo mutex
-	int posMutex;
-	for (i = 0; i < NUM_MUT; i++){
-		if(array_mutex[i].nombre == NULL){
-			mutex *mutexCreado = &(array_mutex[i]);
-			mutexCreado->nombre = strdup(nombre);
-			mutexCreado->tipo=tipo;
-			array_mutex[i].procesos[p_proc_actual->id] = 1;
-			posMutex = i;
-			break;
+	for (linea = texto; linea != NULL; linea = siguiente){
+		siguiente = strchr(linea, '\n');
+		if(siguiente != NULL){
+			*siguiente++ = '\0';
+		}
+		linea = recortar_blancos(linea);
+		if(linea[0] == '\0' || linea[0] == '#'){
+			continue;
 		}
-	}
-	
-	mutexExistentes++;
 
-	// Busca descriptor libre para mutex
-	int df = -4; // Descriptor
-	for (i = 0; i < NUM_MUT_PROC; i++){
-		if(p_proc_actual->array_mutex_proceso[i] == NULL){
-			p_proc_actual->array_mutex_proceso[i] = &array_mutex[posMutex];
-			p_proc_actual->numMutex++;
-			df = i;
-			break;
+		igual = strchr(linea, '=');
+		numero = 0;
+		fin = NULL;
+		valor = NULL;
+		if(igual != NULL){
+			*igual = '\0';
+			linea = recortar_blancos(linea);
+			valor = recortar_blancos(igual + 1);
+			numero = strtol(valor, &fin, 10);
+		}
+		if(valor == NULL || fin == valor || *fin != '\0' ||
+				numero < INT_MIN || numero > INT_MAX ||
+				aplicar_parametro(linea, (int)numero, 1) < 0){
+			printk("-> CONFIGURACION: %s NO VALIDO\n", linea);
+		}
+		else{
+			printk("-> CONFIGURACION: %s = %d\n", linea, (int)numero);
 		}
 	}
-
-	return df;
 }
 
-int sis_abrir_mutex(){
+/*
+ * Crea la arena y reserva en ella las estructuras cuyo tamao fijan los
+ * parmetros: los mutex, los descriptores de mutex de cada proceso y el
+ * buffer del terminal
+ */
+static void reservar_tablas(){
+	int tamMutex = numMut * sizeof(mutex);
+	int tamDescriptores = MAX_PROC * numMutProc * sizeof(mutex *);
+	int i;
+
+	crear_arena(alinear_arena(tamMutex) +
+		alinear_arena(tamDescriptores) + alinear_arena(tamBufTerm));
+	array_mutex = reservar_arena(tamMutex);
+	descriptoresMutex = reservar_arena(tamDescriptores);
+	bufferCaracteres = reservar_arena(tamBufTerm);
+
+	for (i = 0; i < MAX_PROC; i++){
+		tabla_procs[i].array_mutex_proceso =
+			&(descriptoresMutex[i * numMutProc]);
+	}
+}
 
+/*
+ * Devuelve el valor de un parmetro del kernel o -1 si no existe
+ */
+int sis_leer_parametro(){
 	char *nombre = (char *)leer_registro(1);
+	char copia[MAX_NOM_PARAM + 1];
+	parametro *par;
 
-	// Comprueba nmero de mutex del proceso
-	if(p_proc_actual->numMutex == NUM_MUT_PROC){
+	if(copiar_nombre_parametro(nombre, copia) < 0 ||
+			(par = buscar_parametro(copia)) == NULL){
 		return -1;
 	}
+	return *(par->valor);
+}
 
-	int i;
-	int posMutex = -2;
+/*
+ * Cambia en marcha un parmetro del kernel. Devuelve 0, -1 si no existe,
+ * -2 si el valor est fuera de rango o -3 si slo se puede fijar al
+ * arrancar.
+ */
+int sis_fijar_parametro(){
+	char *nombre = (char *)leer_registro(1);
+	int valor = (int)leer_registro(2);
+	char copia[MAX_NOM_PARAM + 1];
+	int res;
 
-	for (i = 0; i < NUM_MUT; i++){
-		if(array_mutex[i].nombre != NULL && strcmp(array_mutex[i].nombre, nombre) == 0){
-			// Mutex encontrado
-			array_mutex[i].procesos[p_proc_actual->id] = 1;
-			posMutex = i;
-			break;
-		}
+	if(copiar_nombre_parametro(nombre, copia) < 0){
+		return -1;
 	}
 
-	if(posMutex == -2){
-		// No existe mutex con ese nombre
-		return -2;
-	}
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	res = aplicar_parametro(copia, valor, 0);
+	fijar_nivel_int(nivel_interrupciones);
 
-	// Busca descriptor libre para mutex
-	int df = -4; // Descriptor
-	for (i = 0; i < NUM_MUT_PROC; i++){
-		if(p_proc_actual->array_mutex_proceso[i] == NULL){
-			p_proc_actual->array_mutex_proceso[i] = &array_mutex[posMutex];
-			p_proc_actual->numMutex++;
-			df = i;
-			break;
-		}
+	if(res == 0){
+		printk("-> PROC %d: PARAMETRO %s = %d\n", p_proc_actual->id,
+			copia, valor);
 	}
-
-	return df;
+	return res;
 }
 
-int sis_cerrar_mutex(){
+/*
+ *
+ * Hilos: tareas que comparten la imagen del proceso que las crea, con su
+ * propia pila y contexto
+ *
+ */
 
-	// Descriptor del mutex que se debe cerrar
-	unsigned int mutexId = (unsigned int)leer_registro(1);
+/*
+ * Crea un hilo que ejecuta la funcin pasndole el argumento y devuelve
+ * su id, o -1 si no hay entradas libres en la tabla de procesos
+ */
+int sis_crear_hilo(){
+	void *funcion = (void *)leer_registro(1);
+	long argumento = leer_registro(2);
+	int proc;
 
-	// Comprueba que el mutex existe
-	if(p_proc_actual->array_mutex_proceso[mutexId] == NULL){
+	proc = buscar_BCP_libre();
+	if(proc == -1){
 		return -1;
 	}
 
-	// Elimina contador de mutex abierto en proceso en array global de mutex
-	int i;
-	for (i = 0; i < NUM_MUT; i++){
-		if(array_mutex[i].nombre != NULL && 
-				strcmp(array_mutex[i].nombre, p_proc_actual->array_mutex_proceso[mutexId]->nombre) == 0){
-			// Mutex encontrado
-			array_mutex[i].procesos[p_proc_actual->id] = 0;
-
-			int cerrarMutex = 1;
-			int k;
-
-			for (k = 0; k < MAX_PROC && cerrarMutex == 1; k++){
-				if(array_mutex[i].procesos[k] == 1){
-					// No hay que cerrar mutex, ya que est abierto por otro proceso
-					cerrarMutex = 0;
-				}
-			}
-
-			if(cerrarMutex == 1){			
-				// Eliminar el mutex global
-				mutexExistentes--;
-				array_mutex[i].nombre = NULL;
-
-				// Desbloquea procesos esperando para crear mutex
-				BCP *procesoADesbloquear = lista_bloqueados.primero;
-				BCP *procesoSiguiente = NULL;
-				if(procesoADesbloquear != NULL){
-					procesoSiguiente = procesoADesbloquear->siguiente;
-				}
-
-				while(procesoADesbloquear != NULL && procesoADesbloquear->bloqueadoCreandoMutex == 1){
-					procesoADesbloquear->estado = LISTO;
-					procesoADesbloquear->bloqueadoCreandoMutex = 0;
-					int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-					eliminar_elem(&lista_bloqueados, procesoADesbloquear);
-					insertar_ultimo(&lista_listos, procesoADesbloquear);
-					fijar_nivel_int(nivel_interrupciones);
-
-					procesoADesbloquear = procesoSiguiente;
-					if(procesoADesbloquear != NULL){
-						procesoSiguiente = procesoADesbloquear->siguiente;
-					}
-				}
-			}
-			break;
-		}
-	}
-
-	// Elimina mutex local abierto
-	p_proc_actual->numMutex--;
-	p_proc_actual->array_mutex_proceso[mutexId] = NULL;
+	printk("-> PROC %d: CREAR HILO %d\n", p_proc_actual->id, proc);
 
-	return 0;
+	tabla_hilos[proc].imagen = p_proc_actual->info_mem;
+	tabla_hilos[proc].terminado = 0;
+	iniciar_tarea(&(tabla_procs[proc]), proc, p_proc_actual->info_mem,
+		funcion, argumento);
+	return proc;
 }
 
-int sis_lock(){
-
-	// Descriptor del mutex que se debe bloquear
-	unsigned int mutexId = (unsigned int)leer_registro(1);
+/*
+ * Espera a que termine un hilo que comparte la imagen del proceso actual
+ * y recoge su valor de terminacin. Devuelve -1 si no es un hilo de la
+ * imagen o si otro ya lo ha recogido.
+ */
+int sis_esperar_hilo(){
+	int id = (int)leer_registro(1);
+	int *valor = (int *)leer_registro(2);
+	hilo *h;
+	int res;
 
-	// Comprueba que el mutex existe
-	if(p_proc_actual->array_mutex_proceso[mutexId] == NULL){
+	if(id < 0 || id >= MAX_PROC || id == p_proc_actual->id){
 		return -1;
 	}
+	h = &(tabla_hilos[id]);
 
-	// Comprueba si est bloqueado por otro proceso	
-	int j;
-	int bloquearMutex = 1;
-	for(j = 0; j < NUM_MUT; j++){
-		if (array_mutex[j].nombre != NULL &&
-			strcmp(array_mutex[j].nombre, p_proc_actual->array_mutex_proceso[mutexId]->nombre) == 0){
-	
-			int i;
-			for(i = 0; i < MAX_PROC; i++){
-				if(array_mutex[j].procesosBloqueados[i] == 1 && 
-					i != p_proc_actual->id){
-
-					// Ya est bloqueado por otro proceso, bloquear actual
-					bloquearMutex = 0;
-					
-					// Bloquear proceso actual
-					p_proc_actual->estado = BLOQUEADO;
-					p_proc_actual->bloqueadoPorMutex = strdup(array_mutex[j].nombre);
-
-					int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-					eliminar_elem(&lista_listos, p_proc_actual);
-					insertar_ultimo(&lista_bloqueados, p_proc_actual);
-					fijar_nivel_int(nivel_interrupciones);
-
-					// Cambio de contexto voluntario
-					BCP *proceso_bloqueado = p_proc_actual;
-					p_proc_actual = planificador();
-					cambio_contexto(&(proceso_bloqueado->contexto_regs), &(p_proc_actual->contexto_regs));
-
-					break;
-				}
-			}
-			break;
-		}
+	int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
+	while(h->imagen == p_proc_actual->info_mem && !h->terminado){
+		bloquear_proceso(&lista_esperando_hilos);
 	}
-
-	if(bloquearMutex == 1){
-		// Bloquear el mutex
+	if(h->imagen != p_proc_actual->info_mem){
+		fijar_nivel_int(nivel_interrupciones);
+		return -1;
 	}
+	res = h->valor;
+	h->imagen = NULL;
+	h->terminado = 0;
+	fijar_nivel_int(nivel_interrupciones);
 
+	if(valor != NULL){
+		accesoParam = 1;
+		*valor = res;
+		accesoParam = 0;
+	}
 	return 0;
 }
 
-int sis_unlock(){
-	return 0;
-}
-
-int sis_leer_caracter(){	
-	while(1){
-		// Si el buffer est vaco se bloquea
-		if(caracteresEnBuffer == 0){
-			p_proc_actual->estado = BLOQUEADO;
-			p_proc_actual->bloqueadoPorLectura = 1;
-			int nivel_interrupciones = fijar_nivel_int(NIVEL_3);
-			eliminar_elem(&lista_listos, p_proc_actual);
-			insertar_ultimo(&lista_bloqueados, p_proc_actual);
-			fijar_nivel_int(nivel_interrupciones);
-
-			nivel_interrupciones = fijar_nivel_int(NIVEL_2);
-			// Cambio de contexto voluntario		
-			BCP *proceso_bloqueado = p_proc_actual;
-			p_proc_actual = planificador();
-			cambio_contexto(&(proceso_bloqueado->contexto_regs), &(p_proc_actual->contexto_regs));
-			fijar_nivel_int(nivel_interrupciones);
-		}
-		else{
-			int i;
-			// Solicita el primer caracter del buffer
-			int nivel_interrupciones = fijar_nivel_int(NIVEL_2);
-			char car = bufferCaracteres[0];
-			caracteresEnBuffer--;
-
-			// Reordena el buffer
-			for (i = 0; i < caracteresEnBuffer; i++){
-				bufferCaracteres[i] = bufferCaracteres[i+1];
-			}
-			fijar_nivel_int(nivel_interrupciones);
-
-			return (long)car;
-		}
-	}	
+/*
+ * Punto de entrada de los procesadores secundarios: se quedan en el
+ * planificador hasta que pueden robar algn proceso
+ */
+static void arranque_secundario(){
+	p_proc_actual=planificador();
+	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
+	panico("S.O. reactivado inesperadamente");
 }
 
 /*
@@ -858,14 +4073,25 @@ int main(){
 	instal_man_int(INT_SW, int_sw); 
 
 	iniciar_cont_int();		/* inicia cont. interr. */
-	iniciar_cont_reloj(TICK);	/* fija frecuencia del reloj */
+	numProcesadores=num_procesadores();
+	leer_configuracion();		/* parmetros del arranque */
+	iniciar_cont_reloj(ticksPorSegundo);	/* fija frecuencia del reloj */
+	iniciar_medias_carga();		/* intervalo y factores segn el tick */
 	iniciar_cont_teclado();		/* inici cont. teclado */
 
 	iniciar_tabla_proc();		/* inicia BCPs de tabla de procesos */
+	reservar_tablas();		/* arena, mutex y buffer segn los parmetros */
+	iniciar_caches();		/* caches de bloques */
+
+	/* pgina de datos que los procesos leen sin hacer llamadas */
+	paginaDatos=crear_pagina_datos(sizeof(pagina_datos), &paginaDatosUsuario);
 
 	/* crea proceso inicial */
 	if (crear_tarea((void *)"init")<0)
 		panico("no encontrado el proceso inicial");
+
+	/* el resto de procesadores esperan a tener algo que ejecutar */
+	arrancar_procesadores(arranque_secundario);
 	
 	/* activa proceso inicial */
 	p_proc_actual=planificador();
@@ -0,0 +1,142 @@
+#!/bin/sh
+#
+# pruebas/pruebas.sh
+#	Ejecuta los escenarios de prueba y compara su salida con la esperada
+#
+# Cada escenario arranca el sistema con un programa inicial, en modo de
+# simulacin para que la salida sea reproducible, y se comprueba que:
+#
+#	- la traza (salida del kernel y de los procesos) coincide con la de
+#	  pruebas/esperado/<escenario>.txt
+#	- no se supera el presupuesto de ticks virtuales del escenario (se
+#	  usa como lmite de la simulacin)
+#	- no se supera el presupuesto de tiempo real en milisegundos
+#
+# Con -r se arranca en tiempo real: las trazas slo se comparan de forma
+# tolerante (sin las lneas del kernel, con los nmeros sustituidos por
+# '#' y sin tener en cuenta el orden) y no se aplican los presupuestos;
+# se omiten los escenarios con entrada, ya que en tiempo real los
+# caracteres que llegan antes de que se lean se pierden.
+# Con -a se regeneran las trazas esperadas en lugar de compararlas.
+# Si existe pruebas/entradas/<escenario>.conf, se usa como fichero de
+# configuracin del arranque.
+#
+#	Uso: pruebas/pruebas.sh [-a] [-r] [escenario ...]
+#
+
+cd "$(dirname "$0")/.." || exit 1
+
+DIR=pruebas
+SALIDAS=$DIR/salidas
+ESCENARIOS=$DIR/escenarios
+PLAZO_REAL=60		# segundos mximos de un escenario en tiempo real
+
+actualizar=0
+real=0
+while getopts ar opcion; do
+	case $opcion in
+	a) actualizar=1 ;;
+	r) real=1 ;;
+	*) echo "Uso: $0 [-a] [-r] [escenario ...]" >&2; exit 2 ;;
+	esac
+done
+shift $((OPTIND-1))
+
+# Deja slo la salida de los procesos, normalizada y ordenada
+tolerante(){
+	grep -v '^->' "$1" | grep -v '^FIN DE LA SIMULACION' |
+		sed 's/[0-9][0-9]*/#/g' | LC_ALL=C sort
+}
+
+# ltimo tick de la traza (al apagarse o al acabar la simulacin)
+ticks_traza(){
+	tail -n 1 "$1" | sed -n 's/.*EN EL TICK \([0-9]*\)$/\1/p
+		s/.*TRAS \([0-9]*\) TICKS$/\1/p'
+}
+
+ahora_ms(){
+	echo $(($(date +%s%N)/1000000))
+}
+
+mkdir -p $SALIDAS
+grep -v '^#' $ESCENARIOS | grep -v '^[[:space:]]*$' > $SALIDAS/escenarios
+fallos=0
+
+while read nombre programa entrada max_ticks max_ms; do
+	if [ $# -gt 0 ]; then
+		case " $* " in *" $nombre "*) ;; *) continue ;; esac
+	fi
+	if [ "$entrada" = "-" ]; then
+		fentrada=/dev/null
+	elif [ $real -eq 1 ]; then
+		echo "$nombre: omitido en tiempo real"
+		continue
+	else
+		fentrada=$DIR/entradas/$entrada
+	fi
+	salida=$SALIDAS/$nombre.txt
+	esperado=$DIR/esperado/$nombre.txt
+
+	# Parmetros del arranque propios del escenario, si los tiene
+	config=$DIR/entradas/$nombre.conf
+	[ -f $config ] || config=
+
+	inicio=$(ahora_ms)
+	if [ $real -eq 1 ]; then
+		MINIKERNEL_INIT=$programa MINIKERNEL_CONFIG=$config \
+		timeout $PLAZO_REAL \
+			boot/boot minikernel/kernel < $fentrada > $salida 2>&1
+	else
+		MINIKERNEL_SIMULACION=1 MINIKERNEL_TICKS_MAX=$max_ticks \
+		MINIKERNEL_INIT=$programa MINIKERNEL_CONFIG=$config \
+		timeout $PLAZO_REAL \
+			boot/boot minikernel/kernel < $fentrada > $salida 2>&1
+	fi
+	estado=$?
+	ms=$(($(ahora_ms)-inicio))
+	ticks=$(ticks_traza $salida)
+
+	error=""
+	comparar=diff
+	if [ $estado -ne 0 ]; then
+		comparar=""
+		error="termina con estado $estado"
+	elif [ $real -eq 0 ] && tail -n 1 $salida | grep -q '^FIN DE LA SIMULACION'; then
+		error="supera el presupuesto de $max_ticks ticks"
+	elif [ $real -eq 0 ] && [ $ms -gt $max_ms ]; then
+		error="supera el presupuesto de $max_ms ms ($ms ms)"
+	elif [ $actualizar -eq 1 ]; then
+		cp $salida $esperado
+	elif [ ! -f $esperado ]; then
+		error="no hay traza esperada"
+		comparar=""
+	elif [ $real -eq 1 ]; then
+		tolerante $esperado > $salida.esperada
+		tolerante $salida > $salida.obtenida
+		cmp -s $salida.esperada $salida.obtenida ||
+			error="la salida de los procesos es distinta"
+	elif ! cmp -s $esperado $salida; then
+		error="la traza es distinta"
+	fi
+
+	if [ -z "$error" ]; then
+		[ $actualizar -eq 1 ] && resultado=actualizada || resultado=correcta
+		echo "$nombre: $resultado ($ticks ticks, $ms ms)"
+		continue
+	fi
+	echo "$nombre: FALLO: $error"
+	if [ -z "$comparar" ]; then
+		:
+	elif [ $real -eq 1 ]; then
+		diff $salida.esperada $salida.obtenida | head -n 10
+	elif [ -f $esperado ]; then
+		diff $esperado $salida | head -n 10
+	fi
+	fallos=$((fallos+1))
+done < $SALIDAS/escenarios
+
+if [ $fallos -gt 0 ]; then
+	echo "$fallos escenarios fallidos"
+	exit 1
+fi
+exit 0
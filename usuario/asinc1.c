@@ -0,0 +1,33 @@
+/*
+ * usuario/asinc1.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de llamadas
+ * asncronas: tiene el mutex bloqueado durante 2 segundos.
+ *
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mut;
+
+	if ((mut=abrir_mutex("masinc"))<0)
+		printf("error abriendo mutex. NO DEBE APARECER\n");
+
+	lock(mut);
+	printf("asinc1 bloquea el mutex\n");
+
+	dormir(2);
+	printf("asinc1 libera el mutex\n");
+	unlock(mut);
+
+	printf("asinc1 termina\n");
+	return 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * usuario/asinc2.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de llamadas
+ * asncronas: cuando prueba_asinc se lo indica, le avisa de que va a
+ * leer, lee un carcter de forma sncrona y se lo pasa por una cola.
+ *
+ */
+
+#include "servicios.h"
+
+int main(){
+	int cola, aviso, leyendo;
+	char car;
+
+	if ((cola=abrir_cola("casinc"))<0 ||
+	    (aviso=abrir_semaforo("sasinc"))<0 ||
+	    (leyendo=abrir_semaforo("sasinc2"))<0)
+		printf("error abriendo cola o semforos. NO DEBE APARECER\n");
+
+	esperar_semaforo(aviso);
+	senalar_semaforo(leyendo);
+	car=leer_caracter();
+	printf("asinc2 lee el carcter %c\n", car);
+	enviar_cola(cola, &car, 1, BLOQUEANTE);
+
+	printf("asinc2 termina\n");
+	return 0;
+}
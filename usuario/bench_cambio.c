@@ -0,0 +1,73 @@
+/*
+ * usuario/bench_cambio.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide el nmero de cambios de contexto por
+ * segundo. Juega al ping-pong con bench_cambio_eco usando semforos, de
+ * manera que en cada ida y vuelta se producen dos cambios de contexto.
+ * Como referencia mide el coste de las mismas llamadas sin bloquearse.
+ * El ping-pong se reparte en rondas para dar la dispersin del coste de
+ * cada cambio.
+ */
+
+#include "servicios.h"
+
+#define ITER_CAMBIO 100000	/* debe coincidir con bench_cambio_eco */
+
+#define RONDAS 5		/* debe dividir a ITER_CAMBIO */
+
+int main(){
+	int muestras[RONDAS];
+	int ping, pong, ref, i, r, t0, t1, total=0;
+
+	printf("bench_cambio: comienza\n");
+
+	if ((ping=crear_semaforo("cping", 0))<0 ||
+	    (pong=crear_semaforo("cpong", 0))<0 ||
+	    (ref=crear_semaforo("cref", 0))<0) {
+		printf("bench_cambio: error creando semforos\n");
+		return 1;
+	}
+
+	if (crear_proceso("bench_cambio_eco")<0) {
+		printf("Error creando bench_cambio_eco\n");
+		return 1;
+	}
+
+	/* referencia: las mismas dos llamadas sin cambio de contexto */
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITER_CAMBIO; i++) {
+		senalar_semaforo(ref);
+		esperar_semaforo(ref);
+	}
+	t1=tiempos_proceso(0);
+	printf("bench_cambio: %d pares de llamadas sin bloqueo en %d ticks\n",
+		ITER_CAMBIO, t1-t0);
+
+	/* ping-pong: cada ida y vuelta son dos cambios de contexto */
+	for (r=0; r<RONDAS; r++) {
+		t0=esperar_tick();
+		for (i=0; i<ITER_CAMBIO/RONDAS; i++) {
+			senalar_semaforo(ping);
+			esperar_semaforo(pong);
+		}
+		t1=tiempos_proceso(0);
+		muestras[r]=ns_por_operacion(t1-t0, 2*(ITER_CAMBIO/RONDAS));
+		total+=t1-t0;
+	}
+	printf("bench_cambio: %d idas y vueltas en %d ticks\n",
+		ITER_CAMBIO, total);
+	if (total>0)
+		printf("bench_cambio: %d cambios de contexto por segundo\n",
+			por_segundo(total, 2*ITER_CAMBIO));
+	informar_medidas("cambio_contexto", "ns", muestras, RONDAS);
+
+	printf("bench_cambio: termina\n");
+	return 0;
+}
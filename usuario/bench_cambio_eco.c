@@ -0,0 +1,33 @@
+/*
+ * usuario/bench_cambio_eco.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de bench_cambio: devuelve cada
+ * seal recibida en "cping" por "cpong".
+ */
+
+#include "servicios.h"
+
+#define ITER_CAMBIO 100000	/* debe coincidir con bench_cambio */
+
+int main(){
+	int ping, pong, i;
+
+	if ((ping=abrir_semaforo("cping"))<0 ||
+	    (pong=abrir_semaforo("cpong"))<0) {
+		printf("bench_cambio_eco: error abriendo semforos\n");
+		return 1;
+	}
+
+	for (i=0; i<ITER_CAMBIO; i++) {
+		esperar_semaforo(ping);
+		senalar_semaforo(pong);
+	}
+	return 0;
+}
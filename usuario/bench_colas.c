@@ -0,0 +1,80 @@
+/*
+ * usuario/bench_colas.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide la latencia y el caudal de las colas de
+ * mensajes con el proceso bench_colas_eco. Como referencia mide el coste
+ * de la llamada escribir con el mismo mensaje, que tambin entra en el
+ * kernel pero no lo copia a ningn otro proceso.
+ */
+
+#include "servicios.h"
+
+#define TAM_MENSAJE 64		/* debe coincidir con bench_colas_eco */
+#define ITER_LATENCIA 2000	/* debe coincidir con bench_colas_eco */
+#define NUM_FLUJO 50000		/* debe coincidir con bench_colas_eco */
+#define LOTE 16
+
+int main(){
+	char mensajes[LOTE][TAM_MENSAJE];
+	int ping, pong, flujo, i, t0, t1;
+
+	printf("bench_colas: comienza\n");
+
+	if ((ping=crear_cola("cping", 1, TAM_MENSAJE))<0 ||
+	    (pong=crear_cola("cpong", 1, TAM_MENSAJE))<0 ||
+	    (flujo=crear_cola("cflujo", 64, TAM_MENSAJE))<0) {
+		printf("bench_colas: error creando colas\n");
+		return 1;
+	}
+
+	if (crear_proceso("bench_colas_eco")<0) {
+		printf("Error creando bench_colas_eco\n");
+		return 1;
+	}
+
+	/* referencia: una entrada al kernel por mensaje sin copiarlo */
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_FLUJO; i++)
+		escribir(mensajes[0], 0);
+	t1=tiempos_proceso(0);
+	printf("bench_colas: escribir %d llamadas en %d ticks\n",
+		NUM_FLUJO, t1-t0);
+
+	/* latencia: ida y vuelta de un mensaje */
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITER_LATENCIA; i++) {
+		enviar_cola(ping, mensajes, 1, BLOQUEANTE);
+		recibir_cola(pong, mensajes, 1, BLOQUEANTE);
+	}
+	t1=tiempos_proceso(0);
+	printf("bench_colas: latencia %d idas y vueltas en %d ticks\n",
+		ITER_LATENCIA, t1-t0);
+
+	/* caudal: un mensaje por llamada */
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_FLUJO; i++)
+		enviar_cola(flujo, mensajes, 1, BLOQUEANTE);
+	recibir_cola(pong, mensajes, 1, BLOQUEANTE);
+	t1=tiempos_proceso(0);
+	printf("bench_colas: caudal %d mensajes de uno en uno en %d ticks\n",
+		NUM_FLUJO, t1-t0);
+
+	/* caudal: LOTE mensajes por llamada */
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_FLUJO; i+=LOTE)
+		enviar_cola(flujo, mensajes, LOTE, BLOQUEANTE);
+	recibir_cola(pong, mensajes, 1, BLOQUEANTE);
+	t1=tiempos_proceso(0);
+	printf("bench_colas: caudal %d mensajes en lotes de %d en %d ticks\n",
+		NUM_FLUJO, LOTE, t1-t0);
+
+	printf("bench_colas: termina\n");
+	return 0;
+}
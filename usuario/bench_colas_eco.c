@@ -0,0 +1,45 @@
+/*
+ * usuario/bench_colas_eco.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de bench_colas: devuelve los
+ * mensajes de "cping" por "cpong" y consume los de "cflujo" en lotes,
+ * avisando por "cpong" al terminar cada fase de caudal.
+ */
+
+#include "servicios.h"
+
+#define TAM_MENSAJE 64		/* debe coincidir con bench_colas */
+#define ITER_LATENCIA 2000	/* debe coincidir con bench_colas */
+#define NUM_FLUJO 50000		/* debe coincidir con bench_colas */
+#define LOTE 16
+
+int main(){
+	char mensajes[LOTE][TAM_MENSAJE];
+	int ping, pong, flujo, i, fase, recibidos;
+
+	if ((ping=abrir_cola("cping"))<0 ||
+	    (pong=abrir_cola("cpong"))<0 ||
+	    (flujo=abrir_cola("cflujo"))<0) {
+		printf("bench_colas_eco: error abriendo colas\n");
+		return 1;
+	}
+
+	for (i=0; i<ITER_LATENCIA; i++) {
+		recibir_cola(ping, mensajes, 1, BLOQUEANTE);
+		enviar_cola(pong, mensajes, 1, BLOQUEANTE);
+	}
+
+	for (fase=0; fase<2; fase++) {
+		for (recibidos=0; recibidos<NUM_FLUJO; )
+			recibidos+=recibir_cola(flujo, mensajes, LOTE, BLOQUEANTE);
+		enviar_cola(pong, mensajes, 1, BLOQUEANTE);
+	}
+	return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * usuario/bench_corrutinas.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide las corrutinas de biblioteca: el tiempo
+ * medio de crear, ejecutar y terminar una corrutina, lanzndolas por
+ * tandas que llenan la tabla con un trabajador y con todos los
+ * trabajadores posibles, y el de cada cambio entre dos corrutinas
+ * que se ceden el paso, comparable con el cambio de contexto del kernel
+ * que mide bench_cambio.
+ */
+
+#include "servicios.h"
+
+#define RONDAS 5
+#define TICKS_RONDA 20		/* duracin de cada ronda */
+#define CESIONES 10000		/* de cada corrutina por ejecucin */
+
+static void vacia(void *arg){
+}
+
+static void cedente(void *arg){
+	int i;
+
+	for (i=0; i<CESIONES; i++)
+		ceder_corrutina();
+}
+
+/*
+ * Tandas de MAX_CORRUTINAS corrutinas que terminan en el acto, repartidas
+ * entre los hilos indicados. Devuelve cuntas se crean, o -1 si falla.
+ */
+static int crear_terminar(char *prueba, int hilos){
+	int muestras[RONDAS];
+	int r, i, n, t0, t1, total=0;
+
+	for (r=0; r<RONDAS; r++) {
+		t0=esperar_tick();
+		n=0;
+		do {
+			for (i=0; i<MAX_CORRUTINAS; i++)
+				crear_corrutina(vacia, 0);
+			if (ejecutar_corrutinas(hilos)<0) {
+				printf("bench_corrutinas: error ejecutando\n");
+				return -1;
+			}
+			n+=MAX_CORRUTINAS;
+		} while ((t1=tiempos_proceso(0))-t0<TICKS_RONDA);
+		muestras[r]=ns_por_operacion(t1-t0, n);
+		total+=n;
+	}
+	informar_medidas(prueba, "ns", muestras, RONDAS);
+	return total;
+}
+
+int main(){
+	int muestras[RONDAS];
+	int r, n, t0, t1, total, mas;
+
+	printf("bench_corrutinas: comienza\n");
+
+	total=crear_terminar("crear_terminar_corrutina", 1);
+	mas=crear_terminar("crear_terminar_corrutina_trabajadores",
+		MAX_TRABAJADORES);
+	if (total<0 || mas<0)
+		return 1;
+	printf("bench_corrutinas: %d corrutinas creadas\n", total+mas);
+
+	/* dos corrutinas que se ceden el paso */
+	for (r=0; r<RONDAS; r++) {
+		t0=esperar_tick();
+		n=0;
+		do {
+			crear_corrutina(cedente, 0);
+			crear_corrutina(cedente, 0);
+			ejecutar_corrutinas(1);
+			n+=2*CESIONES;
+		} while ((t1=tiempos_proceso(0))-t0<TICKS_RONDA);
+		muestras[r]=ns_por_operacion(t1-t0, n);
+	}
+	informar_medidas("ceder_corrutina", "ns", muestras, RONDAS);
+
+	printf("bench_corrutinas: termina\n");
+	return 0;
+}
@@ -0,0 +1,39 @@
+/*
+ * usuario/bench_dormir.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide la precisin del despertar: duerme un
+ * nmero de ticks que vara de una muestra a otra, empezando justo al
+ * comienzo de un tick, y anota cuntos ticks de ms ha tardado en volver
+ * a ejecutar.
+ */
+
+#include "servicios.h"
+
+#define MUESTRAS 20
+#define MAX_DORMIR 5	/* ticks que duerme como mximo */
+
+int main(){
+	int muestras[MUESTRAS];
+	int m, ticks, t0, t1;
+
+	printf("bench_dormir: comienza\n");
+
+	for (m=0; m<MUESTRAS; m++) {
+		ticks=1+m%MAX_DORMIR;
+		t0=esperar_tick();
+		dormir_ticks(ticks);
+		t1=tiempos_proceso(0);
+		muestras[m]=t1-t0-ticks;
+	}
+	informar_medidas("retraso_despertar", "ticks", muestras, MUESTRAS);
+
+	printf("bench_dormir: termina\n");
+	return 0;
+}
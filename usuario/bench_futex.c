@@ -0,0 +1,61 @@
+/*
+ * usuario/bench_futex.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que compara el coste de adquirir y liberar un
+ * cerrojo de biblioteca sin contencin (no entra en el kernel) con el de
+ * hacer lock y unlock de un mutex del kernel.
+ */
+
+#include "servicios.h"
+
+#define ITER_CERROJO 5000000	/* adquirir/liberar de cerrojo */
+#define ITER_MUTEX 20000	/* lock/unlock de mutex */
+
+static cerrojo c;
+
+int main(){
+	int desc, i, t0, t1;
+
+	printf("bench_futex: comienza\n");
+
+	/* con un valor distinto del esperado no debe bloquearse */
+	iniciar_cerrojo(&c);
+	if (futex_esperar((int *)&c.estado, 1)<0)
+		printf("futex_esperar con valor cambiado. DEBE APARECER\n");
+
+	if (futex_despertar((int *)&c.estado, 1)!=0)
+		printf("futex_despertar sin esperas. NO DEBE APARECER\n");
+
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITER_CERROJO; i++) {
+		adquirir_cerrojo(&c);
+		liberar_cerrojo(&c);
+	}
+	t1=tiempos_proceso(0);
+	printf("bench_futex: cerrojo %d adquirir/liberar en %d ticks\n",
+		ITER_CERROJO, t1-t0);
+
+	if ((desc=crear_mutex("mb", NO_RECURSIVO))<0) {
+		printf("bench_futex: error creando mutex\n");
+		return 1;
+	}
+
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITER_MUTEX; i++) {
+		lock(desc);
+		unlock(desc);
+	}
+	t1=tiempos_proceso(0);
+	printf("bench_futex: mutex %d lock/unlock en %d ticks\n",
+		ITER_MUTEX, t1-t0);
+
+	printf("bench_futex: termina\n");
+	return 0;
+}
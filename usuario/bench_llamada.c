@@ -0,0 +1,76 @@
+/*
+ * usuario/bench_llamada.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide la latencia de una llamada al sistema que
+ * no hace nada (fijar_billetes(0), que slo consulta) y, como
+ * comparacin, la de la misma llamada enviada en lotes de TAM_ANILLO y
+ * la de obtener_id_pr, que la biblioteca resuelve leyendo la pgina de
+ * datos del kernel sin entrar en l. Cada ronda repite la operacin en
+ * tandas hasta completar un nmero fijo de ticks.
+ */
+
+#include "servicios.h"
+
+#define RONDAS 7
+#define TICKS_RONDA 20	/* duracin de cada ronda */
+#define TANDA 1000	/* operaciones entre consultas del reloj */
+
+static anillo_llamadas anillo;
+
+static int llamada_nula(){
+	return fijar_billetes(0);
+}
+
+/*
+ * Un lote de TAM_ANILLO llamadas nulas, recogiendo sus terminaciones
+ */
+static int lote_nulo(){
+	int i;
+
+	preparar_lote(&anillo);
+	for (i=0; i<TAM_ANILLO; i++)
+		fijar_billetes(0);
+	enviar_lote();
+	while (recoger_terminacion(&anillo, 0, 0)==0);
+	return 0;
+}
+
+/*
+ * Mide una operacin que equivale a num llamadas y publica el resumen de
+ * las rondas
+ */
+static void medir(char *prueba, int (*operacion)(), int num){
+	int muestras[RONDAS];
+	int r, i, n, t0, t1;
+
+	for (r=0; r<RONDAS; r++) {
+		t0=esperar_tick();
+		n=0;
+		do {
+			for (i=0; i<TANDA; i++)
+				operacion();
+			n+=TANDA;
+		} while ((t1=tiempos_proceso(0))-t0<TICKS_RONDA);
+		muestras[r]=ns_por_operacion(t1-t0, n*num);
+	}
+	informar_medidas(prueba, "ns", muestras, RONDAS);
+}
+
+int main(){
+	printf("bench_llamada: comienza\n");
+
+	iniciar_anillo(&anillo);
+	medir("llamada_nula", llamada_nula, 1);
+	medir("llamada_en_lote", lote_nulo, TAM_ANILLO);
+	medir("id_sin_llamada", obtener_id_pr, 1);
+
+	printf("bench_llamada: termina\n");
+	return 0;
+}
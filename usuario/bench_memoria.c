@@ -0,0 +1,55 @@
+/*
+ * usuario/bench_memoria.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide el caudal de transferencia entre dos
+ * procesos a travs de un segmento de memoria compartida. Escribe
+ * bloques en el segmento que consume el proceso bench_memoria_lector.
+ */
+
+#include "servicios.h"
+
+#define TAM_BLOQUE 65536	/* debe coincidir con bench_memoria_lector */
+#define NUM_BLOQUES 4000	/* debe coincidir con bench_memoria_lector */
+
+int main(){
+	char *bloque;
+	void *p;
+	int vacio, lleno, i, j, t0, t1;
+
+	printf("bench_memoria: comienza\n");
+
+	if (crear_memoria("bloque", TAM_BLOQUE, &p)<0 ||
+	    (vacio=crear_semaforo("vacio", 1))<0 ||
+	    (lleno=crear_semaforo("lleno", 0))<0) {
+		printf("bench_memoria: error creando objetos\n");
+		return 1;
+	}
+	bloque=p;
+
+	if (crear_proceso("bench_memoria_lector")<0) {
+		printf("Error creando bench_memoria_lector\n");
+		return 1;
+	}
+
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_BLOQUES; i++) {
+		esperar_semaforo(vacio);
+		for (j=0; j<TAM_BLOQUE; j++)
+			bloque[j]=(char)i;
+		senalar_semaforo(lleno);
+	}
+	esperar_semaforo(vacio);
+	t1=tiempos_proceso(0);
+
+	printf("bench_memoria: %d KB en %d ticks\n",
+		NUM_BLOQUES*(TAM_BLOQUE/1024), t1-t0);
+	printf("bench_memoria: termina\n");
+	return 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * usuario/bench_memoria_lector.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de bench_memoria: lee cada bloque
+ * del segmento compartido y comprueba su contenido.
+ */
+
+#include "servicios.h"
+
+#define TAM_BLOQUE 65536	/* debe coincidir con bench_memoria */
+#define NUM_BLOQUES 4000	/* debe coincidir con bench_memoria */
+
+int main(){
+	char *bloque;
+	void *p;
+	int vacio, lleno, i, j, errores=0;
+
+	if (asociar_memoria("bloque", &p)<0 ||
+	    (vacio=abrir_semaforo("vacio"))<0 ||
+	    (lleno=abrir_semaforo("lleno"))<0) {
+		printf("bench_memoria_lector: error abriendo objetos\n");
+		return 1;
+	}
+	bloque=p;
+
+	for (i=0; i<NUM_BLOQUES; i++) {
+		esperar_semaforo(lleno);
+		for (j=0; j<TAM_BLOQUE; j++)
+			if (bloque[j]!=(char)i)
+				errores++;
+		senalar_semaforo(vacio);
+	}
+
+	if (errores)
+		printf("bench_memoria_lector: %d bytes erroneos. NO DEBE APARECER\n",
+			errores);
+	return 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * usuario/bench_mutex.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide el coste de lock y unlock de un mutex del
+ * kernel. Sin contencin lo hace un nico proceso; con contencin,
+ * este proceso y NUM_CARGAS procesos bench_mutex_carga hacen lock y
+ * unlock del mismo mutex con una llamada dentro de la seccin crtica,
+ * de modo que se expulsa con frecuencia a quien lo tiene y los dems se
+ * bloquean.
+ */
+
+#include "servicios.h"
+
+#define RONDAS 5
+#define TICKS_RONDA 20		/* duracin de cada ronda sin contencin */
+#define LOTE 1000		/* pares entre consultas del reloj */
+#define NUM_CARGAS 2		/* procesos que compiten por el mutex */
+#define ITER_CONTENCION 20000	/* debe coincidir con bench_mutex_carga */
+
+int main(){
+	int muestras[RONDAS];
+	int mut, fin, r, i, n, t0, t1;
+
+	printf("bench_mutex: comienza\n");
+
+	if ((mut=crear_mutex("bmutex", NO_RECURSIVO))<0 ||
+	    (fin=crear_semaforo("bmfin", 0))<0) {
+		printf("bench_mutex: error creando objetos\n");
+		return 1;
+	}
+
+	for (r=0; r<RONDAS; r++) {
+		t0=esperar_tick();
+		n=0;
+		do {
+			for (i=0; i<LOTE; i++) {
+				lock(mut);
+				unlock(mut);
+			}
+			n+=LOTE;
+		} while ((t1=tiempos_proceso(0))-t0<TICKS_RONDA);
+		muestras[r]=ns_por_operacion(t1-t0, n);
+	}
+	informar_medidas("mutex_sin_contencion", "ns", muestras, RONDAS);
+
+	for (r=0; r<RONDAS; r++) {
+		t0=esperar_tick();
+		for (i=0; i<NUM_CARGAS; i++)
+			if (crear_proceso("bench_mutex_carga")<0) {
+				printf("Error creando bench_mutex_carga\n");
+				return 1;
+			}
+		for (i=0; i<ITER_CONTENCION; i++) {
+			lock(mut);
+			obtener_id_pr();
+			unlock(mut);
+		}
+		for (i=0; i<NUM_CARGAS; i++)
+			esperar_semaforo(fin);
+		t1=tiempos_proceso(0);
+		muestras[r]=ns_por_operacion(t1-t0,
+			(NUM_CARGAS+1)*ITER_CONTENCION);
+	}
+	informar_medidas("mutex_con_contencion", "ns", muestras, RONDAS);
+
+	printf("bench_mutex: termina\n");
+	return 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * usuario/bench_mutex_carga.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario creado por bench_mutex: compite por el mutex y
+ * avisa al terminar.
+ */
+
+#include "servicios.h"
+
+#define ITER_CONTENCION 20000	/* debe coincidir con bench_mutex */
+
+int main(){
+	int mut, fin, i;
+
+	if ((mut=abrir_mutex("bmutex"))<0 ||
+	    (fin=abrir_semaforo("bmfin"))<0) {
+		printf("bench_mutex_carga: error abriendo objetos\n");
+		return 1;
+	}
+
+	for (i=0; i<ITER_CONTENCION; i++) {
+		lock(mut);
+		obtener_id_pr();
+		unlock(mut);
+	}
+	senalar_semaforo(fin);
+	return 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * usuario/bench_nulo.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario creado por bench_procesos: avisa de que ha
+ * arrancado y termina.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int fin;
+
+	if ((fin=abrir_semaforo("bnulo"))>=0)
+		senalar_semaforo(fin);
+	return 0;
+}
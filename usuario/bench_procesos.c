@@ -0,0 +1,68 @@
+/*
+ * usuario/bench_procesos.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide el caudal de creacin y terminacin de
+ * procesos. Crea uno a uno procesos bench_nulo, que slo avisan de que
+ * han arrancado y terminan, y mide el tiempo medio de cada uno. Mide lo
+ * mismo con hilos, que no cargan una imagen nueva.
+ */
+
+#include "servicios.h"
+
+#define RONDAS 5
+#define TICKS_RONDA 20	/* duracin de cada ronda */
+
+static int hilo_nulo(void *arg){
+	return 0;
+}
+
+int main(){
+	int muestras[RONDAS];
+	int fin, r, n, t0, t1;
+
+	printf("bench_procesos: comienza\n");
+
+	if ((fin=crear_semaforo("bnulo", 0))<0) {
+		printf("bench_procesos: error creando semforo\n");
+		return 1;
+	}
+
+	for (r=0; r<RONDAS; r++) {
+		t0=esperar_tick();
+		n=0;
+		do {
+			if (crear_proceso("bench_nulo")<0) {
+				printf("Error creando bench_nulo\n");
+				return 1;
+			}
+			esperar_semaforo(fin);
+			n++;
+		} while ((t1=tiempos_proceso(0))-t0<TICKS_RONDA);
+		muestras[r]=ns_por_operacion(t1-t0, n)/1000;
+	}
+	informar_medidas("crear_terminar_proceso", "us", muestras, RONDAS);
+
+	for (r=0; r<RONDAS; r++) {
+		t0=esperar_tick();
+		n=0;
+		do {
+			if (esperar_hilo(crear_hilo(hilo_nulo, 0), 0)<0) {
+				printf("Error creando hilo\n");
+				return 1;
+			}
+			n++;
+		} while ((t1=tiempos_proceso(0))-t0<TICKS_RONDA);
+		muestras[r]=ns_por_operacion(t1-t0, n)/1000;
+	}
+	informar_medidas("crear_esperar_hilo", "us", muestras, RONDAS);
+
+	printf("bench_procesos: termina\n");
+	return 0;
+}
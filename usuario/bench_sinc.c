@@ -0,0 +1,60 @@
+/*
+ * usuario/bench_sinc.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide el coste de sincronizar dos procesos
+ * usando semforos frente a sondear con dormir. Realiza idas y vueltas
+ * con el proceso bench_sinc_eco por ambos mtodos.
+ */
+
+#include "servicios.h"
+
+#define ITER_SEMAFORO 2000	/* idas y vueltas usando semforos */
+#define ITER_SONDEO 50		/* idas y vueltas sondeando con dormir */
+
+int main(){
+	int ping, pong, i, t0, t1;
+
+	printf("bench_sinc: comienza\n");
+
+	if ((ping=crear_semaforo("ping", 0))<0 ||
+	    (pong=crear_semaforo("pong", 0))<0) {
+		printf("bench_sinc: error creando semforos\n");
+		return 1;
+	}
+
+	if (crear_proceso("bench_sinc_eco")<0) {
+		printf("Error creando bench_sinc_eco\n");
+		return 1;
+	}
+
+	/* Primera fase: el proceso queda bloqueado hasta que le sealan */
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITER_SEMAFORO; i++) {
+		senalar_semaforo(ping);
+		esperar_semaforo(pong);
+	}
+	t1=tiempos_proceso(0);
+	printf("bench_sinc: semaforos %d idas y vueltas en %d ticks\n",
+		ITER_SEMAFORO, t1-t0);
+
+	/* Segunda fase: el proceso sondea el semforo durmiendo entre medias */
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITER_SONDEO; i++) {
+		senalar_semaforo(ping);
+		while (intentar_semaforo(pong)<0)
+			dormir(0);
+	}
+	t1=tiempos_proceso(0);
+	printf("bench_sinc: sondeo %d idas y vueltas en %d ticks\n",
+		ITER_SONDEO, t1-t0);
+
+	printf("bench_sinc: termina\n");
+	return 0;
+}
@@ -0,0 +1,40 @@
+/*
+ * usuario/bench_sinc_eco.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de bench_sinc: devuelve cada
+ * seal recibida en "ping" por "pong" usando el mismo mtodo.
+ */
+
+#include "servicios.h"
+
+#define ITER_SEMAFORO 2000	/* debe coincidir con bench_sinc */
+#define ITER_SONDEO 50		/* debe coincidir con bench_sinc */
+
+int main(){
+	int ping, pong, i;
+
+	if ((ping=abrir_semaforo("ping"))<0 ||
+	    (pong=abrir_semaforo("pong"))<0) {
+		printf("bench_sinc_eco: error abriendo semforos\n");
+		return 1;
+	}
+
+	for (i=0; i<ITER_SEMAFORO; i++) {
+		esperar_semaforo(ping);
+		senalar_semaforo(pong);
+	}
+
+	for (i=0; i<ITER_SONDEO; i++) {
+		while (intentar_semaforo(ping)<0)
+			dormir(0);
+		senalar_semaforo(pong);
+	}
+	return 0;
+}
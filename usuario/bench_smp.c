@@ -0,0 +1,45 @@
+/*
+ * usuario/bench_smp.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide el caudal de trabajo intensivo en UCP
+ * segn el nmero de procesadores (variable de entorno
+ * MINIKERNEL_PROCESADORES al arrancar). Crea varios procesos smp_carga,
+ * que hacen la misma cantidad de clculo, y mide el tiempo real hasta
+ * que terminan todos.
+ */
+
+#include "servicios.h"
+
+#define NUM_CARGAS 4	/* procesos que calculan */
+
+int main(){
+	struct tiempos_ejec t;
+	int fin, i, t0, t1;
+
+	printf("bench_smp: comienza\n");
+
+	if ((fin=crear_semaforo("smp_fin", 0))<0) {
+		printf("bench_smp: error creando semforo\n");
+		return 1;
+	}
+
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_CARGAS; i++)
+		if (crear_proceso("smp_carga")<0)
+			printf("Error creando smp_carga\n");
+	for (i=0; i<NUM_CARGAS; i++)
+		esperar_semaforo(fin);
+	t1=tiempos_proceso(&t);
+
+	printf("bench_smp: %d procesos de clculo en %d ticks\n",
+		NUM_CARGAS, t1-t0);
+	printf("bench_smp: termina\n");
+	return 0;
+}
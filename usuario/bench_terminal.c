@@ -0,0 +1,50 @@
+/*
+ * usuario/bench_terminal.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide el caudal de lectura del terminal. Debe
+ * arrancarse con abundante entrada ya disponible (por ejemplo, redirigida
+ * de un fichero). Cada ronda lee caracteres durante un nmero fijo de
+ * ticks; si deja de llegar entrada se termina con las rondas completadas.
+ */
+
+#include "servicios.h"
+
+#define RONDAS 5
+#define TICKS_RONDA 20		/* duracin de cada ronda */
+#define PLAZO_ENTRADA 1000	/* ms sin entrada tras los que se abandona */
+
+int main(){
+	int muestras[RONDAS];
+	evento ev;
+	int r, n, t0, t1;
+
+	printf("bench_terminal: comienza\n");
+
+	ev.tipo=EV_TERMINAL;
+	for (r=0; r<RONDAS; r++) {
+		t0=esperar_tick();
+		n=0;
+		do {
+			if (esperar_eventos(&ev, 1, PLAZO_ENTRADA)<=0) {
+				printf("bench_terminal: no hay ms entrada\n");
+				informar_medidas("lectura_terminal", "car/s",
+					muestras, r);
+				return 1;
+			}
+			leer_caracter();
+			n++;
+		} while ((t1=tiempos_proceso(0))-t0<TICKS_RONDA);
+		muestras[r]=por_segundo(t1-t0, n);
+	}
+	informar_medidas("lectura_terminal", "car/s", muestras, RONDAS);
+
+	printf("bench_terminal: termina\n");
+	return 0;
+}
@@ -0,0 +1,29 @@
+/*
+ * usuario/carga1.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de cargas medias:
+ * calcula hasta que prueba_carga le indica que termine. Hace una llamada
+ * al sistema en cada vuelta para que en modo de simulacin avance el
+ * reloj.
+ *
+ */
+
+#include "servicios.h"
+
+int main(){
+	int *fin;
+
+	if (asociar_memoria("scarga", (void **)&fin)<0)
+		printf("error asociando segmento. NO DEBE APARECER\n");
+
+	while (!*fin)
+		obtener_id_pr();
+	return 0;
+}
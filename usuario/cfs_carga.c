@@ -0,0 +1,26 @@
+/*
+ * usuario/cfs_carga.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de prueba_cfs: consume UCP sin
+ * bloquearse durante un tiempo fijo.
+ *
+ */
+
+#include "servicios.h"
+
+#define DURACION_CARGA 400	/* debe coincidir con prueba_cfs */
+
+int main(){
+	int t0;
+
+	t0=tiempos_proceso(0);
+	while (tiempos_proceso(0)<t0+DURACION_CARGA);
+	return 0;
+}
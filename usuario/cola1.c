@@ -0,0 +1,43 @@
+/*
+ * usuario/cola1.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de una prueba de las colas de
+ * mensajes: recibe en lotes hasta vaciar la cola.
+ *
+ */
+
+#include "servicios.h"
+
+#define TAM_MENSAJE 16
+#define LOTE 4
+
+int main(){
+	char mensajes[LOTE][TAM_MENSAJE];
+	int desc, i, n, total=0;
+
+	printf("cola1 comienza\n");
+
+	if ((desc=abrir_cola("q1"))<0)
+		printf("error abriendo q1. NO DEBE APARECER\n");
+
+	while (total<6) {
+		n=recibir_cola(desc, mensajes, LOTE, BLOQUEANTE);
+		for (i=0; i<n; i++)
+			printf("cola1 recibe mensaje %c\n", mensajes[i][0]);
+		total+=n;
+	}
+
+	/* nadie ms enva: la recepcin no bloqueante no obtiene nada */
+	if (recibir_cola(desc, mensajes, LOTE, NO_BLOQUEANTE)==0)
+		printf("cola1: cola vaca. DEBE APARECER\n");
+
+	printf("cola1 termina\n");
+	return 0;
+}
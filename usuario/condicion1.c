@@ -0,0 +1,44 @@
+/*
+ * usuario/condicion1.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de una prueba de las condiciones
+ *
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mut, cond, id;
+
+	id=obtener_id_pr();
+	printf("condicion1 (%d) comienza\n", id);
+
+	if ((mut=abrir_mutex("mc"))<0)
+		printf("error abriendo mc. NO DEBE APARECER\n");
+
+	if ((cond=abrir_condicion("c1"))<0)
+		printf("error abriendo c1. NO DEBE APARECER\n");
+
+	if (lock(mut)<0)
+		printf("error en lock de mutex. NO DEBE APARECER\n");
+
+	printf("condicion1 (%d) espera en c1\n", id);
+	if (esperar_condicion(cond, mut)<0)
+		printf("error en esperar_condicion. NO DEBE APARECER\n");
+
+	/* al volver de esperar_condicion se tiene de nuevo el mutex */
+	printf("condicion1 (%d) despierta con el mutex mc\n", id);
+
+	if (unlock(mut)<0)
+		printf("error en unlock de mutex. NO DEBE APARECER\n");
+
+	printf("condicion1 (%d) termina\n", id);
+	return 0;
+}
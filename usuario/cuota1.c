@@ -0,0 +1,38 @@
+/*
+ * usuario/cuota1.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de cuotas de UCP:
+ * forma su propio grupo y no deja de calcular. Hace una llamada al
+ * sistema en cada vuelta para que en modo de simulacin avance el reloj.
+ *
+ */
+
+#include "servicios.h"
+
+struct estado_cuota {
+	int grupo;
+	int vueltas;
+};
+
+int main(){
+	struct estado_cuota *e;
+
+	if (asociar_memoria("scuota", (void **)&e)<0)
+		printf("error asociando segmento. NO DEBE APARECER\n");
+
+	e->grupo=crear_grupo();
+	printf("cuota1 crea el grupo %d\n", e->grupo);
+
+	for (;;) {
+		e->vueltas++;
+		obtener_id_pr();
+	}
+	return 0;
+}
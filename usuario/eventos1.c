@@ -0,0 +1,42 @@
+/*
+ * usuario/eventos1.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de espera de
+ * mltiples eventos: genera un evento cada segundo.
+ *
+ */
+
+#include "servicios.h"
+
+int main(){
+	int sem, cola, mut;
+
+	if ((sem=abrir_semaforo("sev"))<0 ||
+	    (cola=abrir_cola("qev"))<0 ||
+	    (mut=abrir_mutex("mev"))<0)
+		printf("error abriendo objetos. NO DEBE APARECER\n");
+
+	lock(mut);
+
+	dormir(1);
+	printf("eventos1 seala semforo\n");
+	senalar_semaforo(sem);
+
+	dormir(1);
+	printf("eventos1 enva mensaje\n");
+	enviar_cola(cola, "hola", 1, BLOQUEANTE);
+
+	dormir(1);
+	printf("eventos1 libera mutex\n");
+	unlock(mut);
+
+	printf("eventos1 termina\n");
+	return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * usuario/grupo1.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de grupos de procesos.
+ * El primero que arranca crea un grupo, bloquea el mutex y crea otros dos
+ * procesos como l, que heredan el grupo. Todos cuentan sus vueltas en el
+ * segmento compartido con prueba_grupos.
+ *
+ */
+
+#include "servicios.h"
+
+struct estado_grupo {
+	int grupo;
+	int vueltas;
+};
+
+int main(){
+	struct estado_grupo *e;
+	int mut;
+
+	if (asociar_memoria("sgrupo", (void **)&e)<0)
+		printf("error asociando segmento. NO DEBE APARECER\n");
+
+	if (e->grupo==0) {
+		e->grupo=crear_grupo();
+		printf("grupo1 crea el grupo %d\n", e->grupo);
+
+		if ((mut=abrir_mutex("mgrupo"))<0)
+			printf("error abriendo mutex. NO DEBE APARECER\n");
+		lock(mut);
+		printf("grupo1 bloquea el mutex\n");
+
+		crear_proceso("grupo1");
+		crear_proceso("grupo1");
+	}
+
+	for (;;) {
+		e->vueltas++;
+		dormir(1);
+	}
+	return 0;
+}
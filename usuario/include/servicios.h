@@ -25,14 +25,196 @@
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
 
+#define NO_BLOQUEANTE 0
+#define BLOQUEANTE 1
+
 struct tiempos_ejec {
 	int usuario;
 	int sistema;
 };
 
+/* Pgina de datos del kernel, de slo lectura (debe coincidir con
+   pagina_datos en minikernel/include/kernel.h) */
+#define PAGINA_MAX_PROC 10	/* debe coincidir con MAX_PROC */
+
+typedef struct {
+	unsigned int secuencia;	/* impar mientras el kernel la actualiza */
+	int procesadores;
+	int ticks;
+	int id_actual;		/* proceso en ejecucin (con un procesador) */
+	int cambios_contexto;
+	int politica;
+	struct tiempos_ejec tiempos[PAGINA_MAX_PROC];
+} pagina_datos;
+
+/* Anillo de llamadas por lotes (el comienzo debe coincidir con
+   anillo_llamadas en minikernel/include/kernel.h). Los ndices crecen sin
+   lmite y se reducen mdulo TAM_ANILLO */
+#define TAM_ANILLO 64
+#define TAM_TEXTO_LOTE 4096	/* textos de printf pendientes de escribir */
+
+typedef struct {
+	int servicio;
+	long param[5];
+	long dato;		/* se copia en la terminacin */
+} peticion_lote;
+
+typedef struct {
+	long dato;
+	int resultado;
+} terminacion_lote;
+
+typedef struct {
+	unsigned int cab_peticiones;	/* avanza el kernel */
+	unsigned int cola_peticiones;	/* avanza el proceso */
+	peticion_lote peticiones[TAM_ANILLO];
+	unsigned int cab_terminaciones;	/* avanza el proceso */
+	unsigned int cola_terminaciones;	/* avanza el kernel */
+	terminacion_lote terminaciones[TAM_ANILLO];
+	/* Slo de la biblioteca: copia de los textos de printf */
+	unsigned int texto_usado;
+	char texto[TAM_TEXTO_LOTE];
+} anillo_llamadas;
+
+/* Terminacin de una llamada asncrona: su testigo y el resultado que
+   habra devuelto la llamada bloqueante */
+#define MAX_ASINC_PROC 8	/* pendientes o sin recoger por proceso */
+
+typedef struct terminacion_asinc {
+	int testigo;
+	int resultado;
+} terminacion_asinc;
+
+/* Estadsticas de la memoria del kernel: arena del arranque y caches de
+   bloques de las zonas de segmentos y colas (deben coincidir con
+   estad_memoria en minikernel/include/kernel.h) */
+#define NUM_CACHES 15
+
+typedef struct estad_cache {
+	int tam_bloque;
+	int bloques;		/* en todas sus losas */
+	int usados;
+	int max_usados;
+	int reservas;		/* atendidas desde el arranque */
+	int fallos;
+} estad_cache;
+
+typedef struct estad_memoria {
+	int tam_arena;
+	int usado_arena;
+	int tam_heap;		/* losas que no han cabido en la arena */
+	int num_caches;
+	estad_cache caches[NUM_CACHES];
+} estad_memoria;
+
+/* Cuota de UCP de un grupo y sus contadores, en ticks (debe coincidir con
+   estad_cuota en minikernel/include/kernel.h) */
+typedef struct estad_cuota {
+	int cuota;		/* 0 si no tiene lmite */
+	int periodo;
+	int consumido;		/* en el periodo actual */
+	int total;		/* desde que se fij la cuota */
+	int estrangulado;	/* 1 si ha agotado la cuota del periodo */
+	int veces_estrangulado;
+	int ticks_estrangulado;
+} estad_cuota;
+
+/* Cargas medias de 1, 5 y 15 segundos y presin sobre la UCP, en
+   milsimas (debe coincidir con estad_carga en minikernel/include/kernel.h) */
+#define NUM_MEDIAS_CARGA 3
+
+typedef struct estad_carga {
+	int carga[NUM_MEDIAS_CARGA];		/* listos, en ejecucin o esperando un mutex */
+	int presion[NUM_MEDIAS_CARGA];	/* ticks con procesos listos sin procesador */
+	int ejecutables;	/* ahora mismo */
+	int bloqueados;		/* esperando un mutex ahora mismo */
+	int ticks_presion;	/* desde el arranque */
+	int ticks;
+} estad_carga;
+
+/* Tipos de eventos de esperar_eventos */
+#define EV_TERMINAL 0		/* hay caracteres pendientes de leer */
+#define EV_MUTEX 1		/* el mutex est libre */
+#define EV_SEMAFORO 2		/* el semaforo tiene valor positivo */
+#define EV_COLA_RECIBIR 3	/* la cola tiene mensajes */
+#define EV_COLA_ENVIAR 4	/* la cola tiene huecos libres */
+#define EV_TEMPORIZADOR 5	/* el temporizador ha vencido */
+
+/* Polticas de planificacin de los procesos que no son de tiempo real */
+#define PLAN_RR 0
+#define PLAN_STRIDE 1
+#define PLAN_CFS 2
+
+/* Acciones de senalar_grupo sobre los procesos de un grupo */
+#define GRUPO_TERMINAR 0
+#define GRUPO_SUSPENDER 1
+#define GRUPO_REANUDAR 2
+
+#define MAX_EVENTOS 8
+#define SIN_PLAZO -1
+
+typedef struct evento {
+	int tipo;
+	unsigned int desc;	/* descriptor (ignorado en EV_TERMINAL) */
+	int listo;		/* 1 si el evento se ha producido */
+} evento;
+
+/* Cerrojo de usuario: 0 libre, 1 bloqueado, 2 bloqueado con esperas */
+typedef struct {
+	volatile int estado;
+} cerrojo;
+
 /* Funcion de biblioteca */
 int escribirf(const char *formato, ...);
 
+/* Cerrojos de biblioteca que solo entran en el kernel si hay contencion */
+void iniciar_cerrojo(cerrojo *c);
+void adquirir_cerrojo(cerrojo *c);
+int intentar_cerrojo(cerrojo *c);
+void liberar_cerrojo(cerrojo *c);
+
+/* Apoyo a los programas de medida */
+int esperar_tick();	/* espera al comienzo de un tick y lo devuelve */
+int ticks_por_segundo();	/* parmetro tick del kernel */
+int ns_por_operacion(int ticks, int operaciones);
+int por_segundo(int ticks, int operaciones);
+void informar_medidas(char *prueba, char *unidad, int *muestras, int num);
+
+/* Llamadas por lotes. Tras preparar_lote, las llamadas que entran en el
+   kernel no se hacen, sino que se aaden al anillo y devuelven su nmero
+   de orden (o -1 si est lleno), que aparece como dato en su terminacin.
+   Los parmetros por referencia deben seguir siendo vlidos hasta
+   enviar_lote, que ejecuta las pendientes con una sola llamada, deja de
+   encolar y devuelve cuntas se han ejecutado */
+void iniciar_anillo(anillo_llamadas *anillo);
+void preparar_lote(anillo_llamadas *anillo);
+int enviar_lote();
+int recoger_terminacion(anillo_llamadas *anillo, long *dato, int *resultado);
+
+/* Copia coherente de la pgina de datos del kernel (-1 si no la hay).
+   obtener_id_pr y tiempos_proceso la usan para no entrar en el kernel */
+int leer_pagina_datos(pagina_datos *copia);
+
+/* Corrutinas de biblioteca repartidas entre varios hilos del kernel.
+   ejecutar_corrutinas reparte las creadas entre hilos trabajadores y
+   vuelve cuando terminan todas (-1 si alguna se queda sin poder
+   continuar); las que se crean desde una corrutina se quedan en su hilo.
+   Slo cambian de contexto al ceder, dormir o esperar al terminal o a un
+   mutex, y en esas esperas slo se detiene la corrutina. Los mutex
+   abiertos antes de ejecutar_corrutinas valen en todos los hilos, y
+   no deben ser recursivos */
+#define MAX_CORRUTINAS 2048
+#define MAX_TRABAJADORES 4
+
+int crear_corrutina(void (*funcion)(void *), void *arg);
+int ejecutar_corrutinas(int hilos);
+void ceder_corrutina();
+int id_corrutina();
+int dormir_corrutina(unsigned int ticks);
+int leer_caracter_corrutina();
+int lock_corrutina(unsigned int mutexid);
+int unlock_corrutina(unsigned int mutexid);
+
 /* Llamadas al sistema proporcionadas */
 int crear_proceso(char *prog);
 int terminar_proceso();
@@ -48,5 +230,56 @@ int lock(unsigned int mutexid);
 int unlock(unsigned int mutexid);
 int cerrar_mutex(unsigned int mutexid);
 int leer_caracter();
+int crear_semaforo(char *nombre, int valor);
+int abrir_semaforo(char *nombre);
+int esperar_semaforo(unsigned int semid);
+int intentar_semaforo(unsigned int semid);
+int senalar_semaforo(unsigned int semid);
+int cerrar_semaforo(unsigned int semid);
+int crear_condicion(char *nombre);
+int abrir_condicion(char *nombre);
+int esperar_condicion(unsigned int condid, unsigned int mutexid);
+int senalar_condicion(unsigned int condid);
+int difundir_condicion(unsigned int condid);
+int cerrar_condicion(unsigned int condid);
+int futex_esperar(int *dir, int valor);
+int futex_despertar(int *dir, int num);
+int crear_memoria(char *nombre, unsigned int tam, void **dir);
+int asociar_memoria(char *nombre, void **dir);
+int desasociar_memoria(unsigned int memid);
+int crear_cola(char *nombre, int num_mensajes, int tam_mensaje);
+int abrir_cola(char *nombre);
+int enviar_cola(unsigned int colaid, void *mensajes, int num, int bloqueante);
+int recibir_cola(unsigned int colaid, void *mensajes, int num, int bloqueante);
+int cerrar_cola(unsigned int colaid);
+int esperar_eventos(evento *eventos, int num, int plazo_ms);
+int dormir_ticks(unsigned int ticks);
+int dormir_hasta(int tick);
+int crear_temporizador(char *nombre, int periodo_ticks);
+int abrir_temporizador(char *nombre);
+int esperar_temporizador(unsigned int tmpid);
+int cerrar_temporizador(unsigned int tmpid);
+int fijar_tiempo_real(int periodo, int presupuesto);
+int esperar_periodo();
+int fijar_planificacion(int politica);
+int fijar_billetes(int billetes);
+int obtener_pagina_datos(void **dir);
+int procesar_lote(anillo_llamadas *anillo);
+int dormir_asinc(unsigned int segundos);
+int leer_caracter_asinc();
+int lock_asinc(unsigned int mutexid);
+int esperar_terminaciones(terminacion_asinc *terminaciones, int num,
+	int bloqueante);
+int obtener_estad_memoria(estad_memoria *estad);
+int crear_grupo();
+int senalar_grupo(int grupo, int accion);
+int fijar_cuota_grupo(int grupo, int cuota, int periodo);
+int obtener_estad_cuota(int grupo, estad_cuota *estad);
+int obtener_estad_carga(estad_carga *estad);
+int leer_parametro(char *nombre);
+int fijar_parametro(char *nombre, int valor);
+int crear_hilo(int (*funcion)(void *), void *arg);
+int terminar_hilo(int valor);
+int esperar_hilo(int id, int *valor);
 
 #endif /* SERVICIOS_H */
\ No newline at end of file
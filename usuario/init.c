@@ -91,6 +91,136 @@ ALGO COMENTE ESTA PARTE Y DESCOMENTE LA PRUEBA CORRESPONDIENTE */
 		printf("Error creando prueba_term\n");
 */
 
+/* PRUEBA DE SEMFOROS
+	if (crear_proceso("prueba_semaforos")<0)
+		printf("Error creando prueba_semaforos\n");
+*/
+
+/* PRUEBA DE CONDICIONES
+	if (crear_proceso("prueba_condiciones")<0)
+		printf("Error creando prueba_condiciones\n");
+*/
+
+/* MEDIDA DE SINCRONIZACIN CON SEMFOROS FRENTE A SONDEO
+	if (crear_proceso("bench_sinc")<0)
+		printf("Error creando bench_sinc\n");
+*/
+
+/* MEDIDA DE CERROJOS DE BIBLIOTECA FRENTE A MUTEX
+	if (crear_proceso("bench_futex")<0)
+		printf("Error creando bench_futex\n");
+*/
+
+/* PRUEBA DE MEMORIA COMPARTIDA
+	if (crear_proceso("prueba_memoria")<0)
+		printf("Error creando prueba_memoria\n");
+*/
+
+/* MEDIDA DE CAUDAL CON MEMORIA COMPARTIDA
+	if (crear_proceso("bench_memoria")<0)
+		printf("Error creando bench_memoria\n");
+*/
+
+/* PRUEBA DE COLAS DE MENSAJES
+	if (crear_proceso("prueba_colas")<0)
+		printf("Error creando prueba_colas\n");
+*/
+
+/* MEDIDA DE LATENCIA Y CAUDAL DE COLAS DE MENSAJES
+	if (crear_proceso("bench_colas")<0)
+		printf("Error creando bench_colas\n");
+*/
+
+/* PRUEBA DE ESPERA DE MULTIPLES EVENTOS
+	if (crear_proceso("prueba_eventos")<0)
+		printf("Error creando prueba_eventos\n");
+*/
+
+/* PRUEBA DE DORMIR CON PLAZOS ABSOLUTOS Y TEMPORIZADORES PERIODICOS
+	if (crear_proceso("prueba_temporizador")<0)
+		printf("Error creando prueba_temporizador\n");
+*/
+
+/* PRUEBA DE PLANIFICACION DE TIEMPO REAL EDF
+	if (crear_proceso("prueba_edf")<0)
+		printf("Error creando prueba_edf\n");
+*/
+
+/* PRUEBA DE PLANIFICACION PROPORCIONAL STRIDE
+	if (crear_proceso("prueba_stride")<0)
+		printf("Error creando prueba_stride\n");
+*/
+
+/* COMPARACION DE ROUND ROBIN Y CFS CON UN PROCESO INTERACTIVO
+	if (crear_proceso("prueba_cfs")<0)
+		printf("Error creando prueba_cfs\n");
+*/
+
+/* MEDIDA DE CAMBIOS DE CONTEXTO POR SEGUNDO
+	if (crear_proceso("bench_cambio")<0)
+		printf("Error creando bench_cambio\n");
+*/
+
+/* MEDIDA DEL TIEMPO DE CALCULO CON VARIOS PROCESADORES
+	if (crear_proceso("bench_smp")<0)
+		printf("Error creando bench_smp\n");
+*/
+
+/* PRUEBA DE LA PAGINA DE DATOS DEL KERNEL
+	if (crear_proceso("prueba_pagina")<0)
+		printf("Error creando prueba_pagina\n");
+*/
+
+/* PRUEBA DE LAS LLAMADAS POR LOTES
+	if (crear_proceso("prueba_lote")<0)
+		printf("Error creando prueba_lote\n");
+*/
+
+/* PRUEBA DE LAS LLAMADAS ASINCRONAS
+	if (crear_proceso("prueba_asinc")<0)
+		printf("Error creando prueba_asinc\n");
+*/
+
+/* PRUEBA DE LAS CACHES DE BLOQUES DEL KERNEL
+	if (crear_proceso("prueba_caches")<0)
+		printf("Error creando prueba_caches\n");
+*/
+
+/* PRUEBA DE LOS GRUPOS DE PROCESOS
+	if (crear_proceso("prueba_grupos")<0)
+		printf("Error creando prueba_grupos\n");
+*/
+
+/* PRUEBA DE LAS CUOTAS DE UCP DE LOS GRUPOS
+	if (crear_proceso("prueba_cuotas")<0)
+		printf("Error creando prueba_cuotas\n");
+*/
+
+/* PRUEBA DE LAS CARGAS MEDIAS Y LA PRESION SOBRE LA UCP
+	if (crear_proceso("prueba_carga")<0)
+		printf("Error creando prueba_carga\n");
+*/
+
+/* PRUEBA DE LOS PARAMETROS DEL KERNEL
+	if (crear_proceso("prueba_parametros")<0)
+		printf("Error creando prueba_parametros\n");
+*/
+
+/* PRUEBA DE LOS HILOS
+	if (crear_proceso("prueba_hilos")<0)
+		printf("Error creando prueba_hilos\n");
+*/
+
+/* PRUEBA DE LAS CORRUTINAS
+	if (crear_proceso("prueba_corrutinas")<0)
+		printf("Error creando prueba_corrutinas\n");
+*/
+
+/* MEDIDAS DE LA BATERIA DE make bench (una por arranque)
+	if (crear_proceso("bench_llamada")<0)
+		printf("Error creando bench_llamada\n");
+*/
+
 	printf("init: termina\n");
 	return 0; 
 }
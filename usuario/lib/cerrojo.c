@@ -0,0 +1,60 @@
+/*
+ *  usuario/lib/cerrojo.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ *
+ * Fichero que contiene la implementacin de los cerrojos de biblioteca.
+ * Sin contencin adquirir y liberar se resuelven con una nica operacin
+ * atmica; slo si hay procesos esperando se usan las llamadas futex.
+ *
+ * Estados: 0 libre, 1 bloqueado sin esperas, 2 bloqueado con esperas
+ *
+ */
+
+#include "servicios.h"
+
+void iniciar_cerrojo(cerrojo *c){
+	c->estado=0;
+}
+
+void adquirir_cerrojo(cerrojo *c){
+	int previo=0;
+
+	/* camino rpido: libre -> bloqueado */
+	if (__atomic_compare_exchange_n(&c->estado, &previo, 1, 0,
+			__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		return;
+
+	/* hay contencin: se marca que hay esperas y se duerme en el kernel */
+	if (previo!=2)
+		previo=__atomic_exchange_n(&c->estado, 2, __ATOMIC_ACQUIRE);
+	while (previo!=0) {
+		futex_esperar((int *)&c->estado, 2);
+		previo=__atomic_exchange_n(&c->estado, 2, __ATOMIC_ACQUIRE);
+	}
+}
+
+int intentar_cerrojo(cerrojo *c){
+	int previo=0;
+
+	if (__atomic_compare_exchange_n(&c->estado, &previo, 1, 0,
+			__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		return 0;
+	return -1;
+}
+
+void liberar_cerrojo(cerrojo *c){
+	/* camino rpido: nadie espera */
+	if (__atomic_fetch_sub(&c->estado, 1, __ATOMIC_RELEASE)==1)
+		return;
+
+	/* haba esperas: se libera y se despierta a uno */
+	__atomic_store_n(&c->estado, 0, __ATOMIC_RELEASE);
+	futex_despertar((int *)&c->estado, 1);
+}
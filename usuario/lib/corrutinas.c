@@ -0,0 +1,611 @@
+/*
+ *  usuario/lib/corrutinas.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ *
+ * Fichero que contiene las corrutinas de biblioteca: muchas tareas
+ * cooperativas repartidas entre unos pocos hilos del kernel, los
+ * trabajadores. Cada trabajador tiene su cola de corrutinas listas, las
+ * dormidas ordenadas por tick de despertar y las que esperan una llamada
+ * asncrona, y slo l las toca, por lo que no hacen falta cerrojos salvo
+ * para la tabla de corrutinas libres.
+ *
+ * Una corrutina se queda siempre en el trabajador que la ejecuta: los
+ * mutex del kernel que usa tienen como propietario al hilo, as que
+ * siguen siendo vlidos; los descriptores son del hilo, que hereda los
+ * que el proceso tena abiertos al crearlo. Las esperas
+ * al terminal, a un mutex o a un plazo slo detienen a la corrutina: se
+ * hacen con las llamadas asncronas y el propio trabajador recoge sus
+ * terminaciones. Slo cuando no tiene nada que ejecutar se bloquea en el
+ * kernel.
+ *
+ * Las corrutinas y sus pilas salen de una tabla esttica, ya que los
+ * programas no disponen de memoria dinmica, y la corrutina en ejecucin
+ * se deduce de la direccin de la pila en uso. Las interrupciones que
+ * llegan mientras se ejecuta una corrutina usan tambin su pila.
+ *
+ * Cambio de contexto: cambio de pila en ensamblador en x86-64, como en el
+ * HAL, y ucontext en el resto de arquitecturas.
+ *
+ */
+
+#include <string.h>
+
+#include "servicios.h"
+
+#if defined(__x86_64__) && !defined(CAMBIO_CONTEXTO_UCONTEXT)
+#define CAMBIO_PILA
+#else
+#include <ucontext.h>
+#endif
+
+/* Las llamadas al sistema se tratan en la pila en uso, as que la de una
+   corrutina es como la de un proceso (TAM_PILA en el kernel). Su palabra
+   ms baja es un centinela que revela si se ha desbordado. */
+#define TAM_PILA_CORRUTINA 32768
+#define CENTINELA_PILA 0x5ca1ab1e5ca1ab1eUL
+#define SONDEO_TERMINACIONES 32	/* corrutinas ejecutadas entre sondeos */
+
+/* Estados de una corrutina */
+#define C_LIBRE 0
+#define C_LISTA 1
+#define C_EJECUCION 2
+#define C_DORMIDA 3
+#define C_ASINC 4	/* espera la terminacin de una llamada asncrona */
+#define C_HUECO 5	/* espera hueco para hacer una llamada asncrona */
+#define C_MUTEX 6	/* espera un mutex pedido por otra del mismo hilo */
+#define C_TERMINADA 7
+
+#define SIN_MUTEX -1
+
+#ifdef CAMBIO_PILA
+typedef void *contexto_corrutina;	/* puntero de pila salvado */
+#else
+typedef ucontext_t contexto_corrutina;
+#endif
+
+struct trabajador;
+
+typedef struct corrutina {
+	int estado;
+	void (*funcion)(void *);
+	void *arg;
+	struct trabajador *trab;
+	struct corrutina *siguiente;	/* en la cola en que est */
+	int despertar;			/* tick, si est dormida */
+	int testigo;			/* de la llamada asncrona pendiente */
+	int resultado;
+	int mutexid;			/* pedido, o SIN_MUTEX */
+	contexto_corrutina contexto;
+} corrutina;
+
+typedef struct {
+	corrutina *primera;
+	corrutina *ultima;
+} cola_corrutinas;
+
+typedef struct trabajador {
+	cola_corrutinas listas;
+	corrutina *dormidas;		/* ordenadas por tick de despertar */
+	cola_corrutinas asinc;		/* con una llamada en el kernel */
+	cola_corrutinas hueco;
+	cola_corrutinas mutex;
+	int pendientes;			/* llamadas asncronas sin recoger */
+	int vivas;
+	int ejecutadas;			/* desde el ltimo sondeo */
+	contexto_corrutina planificador;
+} trabajador;
+
+static corrutina corrutinas[MAX_CORRUTINAS];
+static char pilas[MAX_CORRUTINAS][TAM_PILA_CORRUTINA]
+	__attribute__((aligned(16)));
+
+/* Corrutinas libres: las usadas alguna vez se reciclan en una lista */
+static cerrojo cerrojo_libres;
+static corrutina *libres=NULL;
+static int nunca_usadas=0;	/* ndice de la primera sin estrenar */
+
+/* Creadas antes de ejecutar_corrutinas, que las reparte */
+static cola_corrutinas iniciales;
+
+static trabajador trabajadores[MAX_TRABAJADORES];
+
+/*
+ *
+ * Cambio de contexto
+ *
+ */
+
+#ifdef CAMBIO_PILA
+
+/*
+ * conmutar_pila(&pila_a_salvar, pila_a_restaurar) es el cambiar_pila del
+ * HAL: apila los registros que el ABI obliga a conservar, cambia de pila y
+ * desapila los del otro contexto. A diferencia del HAL, tras el cambio no
+ * hay un sigreturn que restaure el estado de coma flotante, as que
+ * tambin guarda el MXCSR y la palabra de control del x87, que el ABI
+ * obliga a conservar: si no, el redondeo o las mscaras de excepcin que
+ * cambia una corrutina pasaran a las dems. Una corrutina nueva retorna a
+ * inicio_corrutina, que llama a la funcin que hay en r13 pasndole como
+ * argumento el valor de r12.
+ */
+void conmutar_pila(void **pila_a_salvar, void *pila_a_restaurar)
+	__attribute__((visibility("hidden")));
+void inicio_corrutina(void) __attribute__((visibility("hidden")));
+
+__asm__(
+	"	.text\n"
+	"	.globl conmutar_pila\n"
+	"	.hidden conmutar_pila\n"
+	"	.type conmutar_pila, @function\n"
+	"conmutar_pila:\n"
+	"	pushq %rbp\n"
+	"	pushq %rbx\n"
+	"	pushq %r12\n"
+	"	pushq %r13\n"
+	"	pushq %r14\n"
+	"	pushq %r15\n"
+	"	subq $8, %rsp\n"
+	"	stmxcsr (%rsp)\n"
+	"	fnstcw 4(%rsp)\n"
+	"	movq %rsp, (%rdi)\n"
+	"	movq %rsi, %rsp\n"
+	"	ldmxcsr (%rsp)\n"
+	"	fldcw 4(%rsp)\n"
+	"	addq $8, %rsp\n"
+	"	popq %r15\n"
+	"	popq %r14\n"
+	"	popq %r13\n"
+	"	popq %r12\n"
+	"	popq %rbx\n"
+	"	popq %rbp\n"
+	"	ret\n"
+	"	.size conmutar_pila, .-conmutar_pila\n"
+	"	.globl inicio_corrutina\n"
+	"	.hidden inicio_corrutina\n"
+	"	.type inicio_corrutina, @function\n"
+	"inicio_corrutina:\n"
+	"	movq %r12, %rdi\n"
+	"	call *%r13\n"
+	"	ud2\n"
+	"	.size inicio_corrutina, .-inicio_corrutina\n"
+);
+
+/* Palabras apiladas por conmutar_pila, en el orden en que las desapila.
+   PILA_FPU lleva el MXCSR en los 4 bytes bajos y la palabra de control
+   del x87 en los 2 siguientes. */
+enum { PILA_FPU, PILA_R15, PILA_R14, PILA_R13, PILA_R12, PILA_RBX,
+	PILA_RBP, PILA_RETORNO, PILA_PALABRAS };
+
+/* Estado de coma flotante con el que empieza una corrutina: el inicial
+   del ABI, redondeo al ms prximo y todas las excepciones enmascaradas */
+#define MXCSR_INICIAL 0x1f80L
+#define CONTROL_X87_INICIAL 0x037fL
+
+#endif /* CAMBIO_PILA */
+
+static void conmutar(contexto_corrutina *salvar,
+			contexto_corrutina *restaurar){
+#ifdef CAMBIO_PILA
+	conmutar_pila(salvar, *restaurar);
+#else
+	swapcontext(salvar, restaurar);
+#endif
+}
+
+/*
+ * Ejecuta la funcin de la corrutina y vuelve al planificador, que la
+ * libera; nunca retorna
+ */
+static void arranque_corrutina(corrutina *c){
+	c->funcion(c->arg);
+	c->estado=C_TERMINADA;
+	conmutar(&c->contexto, &c->trab->planificador);
+}
+
+#ifndef CAMBIO_PILA
+/* makecontext slo garantiza el paso de argumentos int */
+static void arranque_ucontext(int indice){
+	arranque_corrutina(&corrutinas[indice]);
+}
+#endif
+
+static void preparar_contexto(corrutina *c){
+	int indice=c-corrutinas;
+
+	*(unsigned long *)pilas[indice]=CENTINELA_PILA;
+#ifdef CAMBIO_PILA
+	long *pila;
+
+	/* a la vuelta de conmutar_pila la pila debe quedar alineada a 16 */
+	pila=(long *)(((unsigned long)pilas[indice]+TAM_PILA_CORRUTINA)&~15UL)-
+		2-PILA_PALABRAS;
+	memset(pila, 0, PILA_PALABRAS*sizeof(long));
+	pila[PILA_FPU]=MXCSR_INICIAL|(CONTROL_X87_INICIAL<<32);
+	pila[PILA_R12]=(long)c;
+	pila[PILA_R13]=(long)arranque_corrutina;
+	pila[PILA_RETORNO]=(long)inicio_corrutina;
+	c->contexto=pila;
+#else
+	getcontext(&c->contexto);
+	c->contexto.uc_stack.ss_sp=pilas[indice];
+	c->contexto.uc_stack.ss_size=TAM_PILA_CORRUTINA;
+	c->contexto.uc_link=NULL;
+	makecontext(&c->contexto, (void (*)())arranque_ucontext, 1, indice);
+#endif
+}
+
+/*
+ * Corrutina en ejecucin, deducida de la pila en uso; NULL si no se est
+ * ejecutando ninguna
+ */
+static corrutina *corrutina_actual(){
+	char local;
+	unsigned long desp=(unsigned long)&local-(unsigned long)pilas;
+
+	if (desp>=sizeof(pilas))
+		return NULL;
+	return &corrutinas[desp/TAM_PILA_CORRUTINA];
+}
+
+/*
+ * Comprueba el centinela de la pila de la corrutina. Si se ha desbordado
+ * ha podido pisar otras pilas, as que se termina el hilo.
+ */
+static void comprobar_pila(corrutina *c){
+	if (*(unsigned long *)pilas[c-corrutinas]!=CENTINELA_PILA) {
+		printf("corrutina %d: desbordamiento de pila\n",
+			(int)(c-corrutinas));
+		terminar_proceso();
+	}
+}
+
+/* Detiene la corrutina en el estado indicado y vuelve al planificador */
+static void parar(corrutina *c, int estado){
+	c->estado=estado;
+	conmutar(&c->contexto, &c->trab->planificador);
+}
+
+/*
+ *
+ * Colas y tabla de corrutinas
+ *
+ */
+
+static void encolar(cola_corrutinas *cola, corrutina *c){
+	c->siguiente=NULL;
+	if (cola->ultima)
+		cola->ultima->siguiente=c;
+	else
+		cola->primera=c;
+	cola->ultima=c;
+}
+
+static corrutina *desencolar(cola_corrutinas *cola){
+	corrutina *c=cola->primera;
+
+	if (c) {
+		cola->primera=c->siguiente;
+		if (cola->primera==NULL)
+			cola->ultima=NULL;
+	}
+	return c;
+}
+
+static corrutina *reservar_corrutina(){
+	corrutina *c=NULL;
+
+	adquirir_cerrojo(&cerrojo_libres);
+	if (libres) {
+		c=libres;
+		libres=c->siguiente;
+	}
+	else if (nunca_usadas<MAX_CORRUTINAS)
+		c=&corrutinas[nunca_usadas++];
+	liberar_cerrojo(&cerrojo_libres);
+	return c;
+}
+
+static void liberar_corrutina(corrutina *c){
+	c->estado=C_LIBRE;
+	adquirir_cerrojo(&cerrojo_libres);
+	c->siguiente=libres;
+	libres=c;
+	liberar_cerrojo(&cerrojo_libres);
+}
+
+/* Pasa a listas las que esperan el mutex, para que lo vuelvan a pedir */
+static void despertar_mutex(trabajador *t, int mutexid){
+	cola_corrutinas resto={NULL, NULL};
+	corrutina *c;
+
+	while ((c=desencolar(&t->mutex))) {
+		if (c->mutexid==mutexid) {
+			c->estado=C_LISTA;
+			encolar(&t->listas, c);
+		}
+		else
+			encolar(&resto, c);
+	}
+	t->mutex=resto;
+}
+
+/*
+ *
+ * Planificador de cada trabajador
+ *
+ */
+
+/*
+ * Recoge las terminaciones de las llamadas asncronas del hilo y pasa a
+ * listas a sus corrutinas y a las que esperaban hueco para una llamada
+ */
+static void recoger_terminaciones(trabajador *t, int bloqueante){
+	terminacion_asinc term[MAX_ASINC_PROC];
+	corrutina *c, *ant;
+	int i, n;
+
+	n=esperar_terminaciones(term, MAX_ASINC_PROC, bloqueante);
+	for (i=0; i<n; i++) {
+		for (ant=NULL, c=t->asinc.primera;
+		     c && c->testigo!=term[i].testigo; ant=c, c=c->siguiente)
+			;
+		if (c==NULL)
+			continue;
+		if (ant)
+			ant->siguiente=c->siguiente;
+		else
+			t->asinc.primera=c->siguiente;
+		if (t->asinc.ultima==c)
+			t->asinc.ultima=ant;
+		t->pendientes--;
+		c->resultado=term[i].resultado;
+		c->estado=C_LISTA;
+		encolar(&t->listas, c);
+
+		/* un lock cancelado no va a dar paso a las que esperan detrs */
+		if (c->mutexid!=SIN_MUTEX && c->resultado<0)
+			despertar_mutex(t, c->mutexid);
+	}
+	while (n>0 && (c=desencolar(&t->hueco))) {
+		c->estado=C_LISTA;
+		encolar(&t->listas, c);
+	}
+}
+
+static void despertar_dormidas(trabajador *t){
+	int ahora=tiempos_proceso(NULL);
+	corrutina *c;
+
+	while ((c=t->dormidas) && c->despertar<=ahora) {
+		t->dormidas=c->siguiente;
+		c->estado=C_LISTA;
+		encolar(&t->listas, c);
+	}
+}
+
+/*
+ * Bloquea al hilo hasta que alguna corrutina pueda continuar. Si espera
+ * a la vez plazos y terminaciones, que el kernel no atiende en una misma
+ * llamada, sondea cada tick. Devuelve -1 si ninguna puede continuar.
+ */
+static int esperar_trabajo(trabajador *t){
+	if (t->dormidas==NULL && t->pendientes==0)
+		return -1;
+	if (t->dormidas==NULL)
+		recoger_terminaciones(t, BLOQUEANTE);
+	else if (t->pendientes==0)
+		dormir_hasta(t->dormidas->despertar);
+	else
+		dormir_ticks(1);
+	return 0;
+}
+
+/*
+ * Ejecuta las corrutinas del trabajador hasta que terminan todas. Las
+ * terminaciones y los plazos se revisan cuando se vaca la cola de listas
+ * o, si no se vaca, cada SONDEO_TERMINACIONES corrutinas ejecutadas.
+ * Devuelve -1 si quedan corrutinas que ya no pueden continuar.
+ */
+static int planificar(trabajador *t){
+	corrutina *c;
+
+	while (t->vivas>0) {
+		if (t->listas.primera==NULL ||
+		    t->ejecutadas>=SONDEO_TERMINACIONES) {
+			t->ejecutadas=0;
+			if (t->pendientes>0)
+				recoger_terminaciones(t, NO_BLOQUEANTE);
+			if (t->dormidas)
+				despertar_dormidas(t);
+		}
+		if ((c=desencolar(&t->listas))) {
+			t->ejecutadas++;
+			c->estado=C_EJECUCION;
+			conmutar(&t->planificador, &c->contexto);
+			comprobar_pila(c);
+			if (c->estado==C_TERMINADA) {
+				t->vivas--;
+				liberar_corrutina(c);
+			}
+		}
+		else if (esperar_trabajo(t)<0)
+			return -1;
+	}
+	return 0;
+}
+
+static int trabajar(void *arg){
+	return planificar((trabajador *)arg);
+}
+
+/*
+ *
+ * Interfaz de las corrutinas
+ *
+ */
+
+int crear_corrutina(void (*funcion)(void *), void *arg){
+	corrutina *actual=corrutina_actual();
+	corrutina *c;
+
+	if ((c=reservar_corrutina())==NULL)
+		return -1;
+	c->funcion=funcion;
+	c->arg=arg;
+	c->mutexid=SIN_MUTEX;
+	c->estado=C_LISTA;
+	preparar_contexto(c);
+
+	/* desde una corrutina, se queda en su trabajador */
+	if (actual) {
+		c->trab=actual->trab;
+		c->trab->vivas++;
+		encolar(&c->trab->listas, c);
+	}
+	else
+		encolar(&iniciales, c);
+	return c-corrutinas;
+}
+
+/*
+ * Reparte las corrutinas creadas hasta ahora entre el proceso y hilos-1
+ * hilos nuevos, y vuelve cuando han terminado todas. Si no se pueden
+ * crear todos los hilos, las del resto se quedan en el proceso.
+ */
+int ejecutar_corrutinas(int hilos){
+	int id[MAX_TRABAJADORES];
+	corrutina *c;
+	int i, n, valor, error=0;
+
+	if (hilos<1 || hilos>MAX_TRABAJADORES || corrutina_actual())
+		return -1;
+
+	memset(trabajadores, 0, hilos*sizeof(trabajador));
+	for (i=0; (c=desencolar(&iniciales)); i=(i+1)%hilos) {
+		c->trab=&trabajadores[i];
+		c->trab->vivas++;
+		encolar(&c->trab->listas, c);
+	}
+
+	for (i=1; i<hilos; i++)
+		if ((id[i]=crear_hilo(trabajar, &trabajadores[i]))<0)
+			break;
+	for (n=i; i<hilos; i++)
+		while ((c=desencolar(&trabajadores[i].listas))) {
+			c->trab=&trabajadores[0];
+			trabajadores[0].vivas++;
+			encolar(&trabajadores[0].listas, c);
+		}
+	hilos=n;
+
+	if (planificar(&trabajadores[0])<0)
+		error=-1;
+	for (i=1; i<hilos; i++)
+		if (esperar_hilo(id[i], &valor)<0 || valor<0)
+			error=-1;
+	return error;
+}
+
+void ceder_corrutina(){
+	corrutina *c=corrutina_actual();
+
+	if (c==NULL)
+		return;
+	encolar(&c->trab->listas, c);
+	parar(c, C_LISTA);
+}
+
+int id_corrutina(){
+	corrutina *c=corrutina_actual();
+
+	return c ? c-corrutinas : -1;
+}
+
+int dormir_corrutina(unsigned int ticks){
+	corrutina *c=corrutina_actual();
+	corrutina **p;
+
+	if (c==NULL)
+		return dormir_ticks(ticks);
+
+	c->despertar=tiempos_proceso(NULL)+ticks;
+	for (p=&c->trab->dormidas; *p && (*p)->despertar<=c->despertar;
+	     p=&(*p)->siguiente)
+		;
+	c->siguiente=*p;
+	*p=c;
+	parar(c, C_DORMIDA);
+	return 0;
+}
+
+/*
+ * Hace la llamada asncrona por cuenta de la corrutina y la detiene hasta
+ * que el trabajador recoge su terminacin. Si el hilo tiene ya todas las
+ * llamadas que admite el kernel, espera antes a que se libere una.
+ */
+static int esperar_asinc(corrutina *c, int mutexid){
+	trabajador *t=c->trab;
+	int testigo;
+
+	while (t->pendientes>=MAX_ASINC_PROC) {
+		encolar(&t->hueco, c);
+		parar(c, C_HUECO);
+	}
+	if (mutexid==SIN_MUTEX)
+		testigo=leer_caracter_asinc();
+	else
+		testigo=lock_asinc(mutexid);
+	if (testigo<0)
+		return testigo;
+
+	t->pendientes++;
+	c->testigo=testigo;
+	c->mutexid=mutexid;
+	encolar(&t->asinc, c);
+	parar(c, C_ASINC);
+	c->mutexid=SIN_MUTEX;
+	return c->resultado;
+}
+
+int leer_caracter_corrutina(){
+	corrutina *c=corrutina_actual();
+
+	if (c==NULL)
+		return leer_caracter();
+	return esperar_asinc(c, SIN_MUTEX);
+}
+
+/*
+ * El kernel rechaza con -2 el lock de un hilo sobre un mutex no recursivo
+ * que ya tiene o ya ha pedido: lo tiene otra corrutina del mismo hilo, as
+ * que se espera a que lo suelte y se vuelve a pedir
+ */
+int lock_corrutina(unsigned int mutexid){
+	corrutina *c=corrutina_actual();
+	int res;
+
+	if (c==NULL)
+		return lock(mutexid);
+	while ((res=esperar_asinc(c, mutexid))==-2) {
+		c->mutexid=mutexid;
+		encolar(&c->trab->mutex, c);
+		parar(c, C_MUTEX);
+	}
+	return res;
+}
+
+int unlock_corrutina(unsigned int mutexid){
+	corrutina *c=corrutina_actual();
+	int res;
+
+	if ((res=unlock(mutexid))==0 && c)
+		despertar_mutex(c->trab, mutexid);
+	return res;
+}
@@ -0,0 +1,74 @@
+/*
+ *  usuario/lib/medidas.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ *
+ * Fichero que contiene las funciones de apoyo de los programas de
+ * medida: sincronizacin con el reloj, conversin de ticks a tiempo por
+ * operacin y resumen de las muestras de varias rondas en una lnea
+ * fcil de procesar:
+ *
+ *	BENCH prueba unidad mnimo mediana mximo muestras
+ *
+ */
+
+#include "servicios.h"
+
+/* Mximo de muestras que se resumen */
+#define MAX_MUESTRAS 64
+
+/* Frecuencia del reloj: slo se fija en el arranque, as que se lee una
+   vez */
+static int frecuencia=0;
+
+int ticks_por_segundo(){
+	if (frecuencia<=0)
+		frecuencia=leer_parametro("tick");
+	return frecuencia;
+}
+
+int esperar_tick(){
+	int t0, t;
+
+	t0=tiempos_proceso(0);
+	while ((t=tiempos_proceso(0))==t0);
+	return t;
+}
+
+int ns_por_operacion(int ticks, int operaciones){
+	if (operaciones<=0)
+		return 0;
+	return (int)(ticks*(1000000000LL/ticks_por_segundo())/operaciones);
+}
+
+int por_segundo(int ticks, int operaciones){
+	if (ticks<=0)
+		return 0;
+	return (int)((long long)operaciones*ticks_por_segundo()/ticks);
+}
+
+void informar_medidas(char *prueba, char *unidad, int *muestras, int num){
+	int orden[MAX_MUESTRAS];
+	int i, j, v;
+
+	if (num>MAX_MUESTRAS)
+		num=MAX_MUESTRAS;
+	if (num<=0)
+		return;
+
+	/* insercin directa: son pocas muestras */
+	for (i=0; i<num; i++) {
+		v=muestras[i];
+		for (j=i; j>0 && orden[j-1]>v; j--)
+			orden[j]=orden[j-1];
+		orden[j]=v;
+	}
+	printf("BENCH %s %s %d %d %d %d\n", prueba, unidad, orden[0],
+		orden[num/2], orden[num-1], num);
+}
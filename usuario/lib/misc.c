@@ -0,0 +1,252 @@
+/*
+ *  usuario/lib/misc.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ *
+ * Fichero que contiene las funciones de apoyo de la biblioteca de
+ * usuario: la instruccin de llamada al sistema, las llamadas por lotes
+ * y escribirf.
+ *
+ */
+
+#define _GNU_SOURCE
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+
+#include "llamsis.h"
+#include "servicios.h"
+
+/* Seal usada como instruccin de llamada al sistema (ver HAL.c) */
+#define SENAL_LLAMSIS SIGUSR2
+
+/* Nmero de registros generales del procesador (ver HAL.h) */
+#define NREGS 6
+
+/* Tamao del buffer usado por escribirf */
+#define TAM_BUF_ESCRIBIRF 1024
+
+/* Anillo en el que se encolan las llamadas mientras se prepara un lote.
+   Los hilos de un proceso comparten su copia de la biblioteca, as que
+   hay uno por identificador; mientras nadie prepara un lote no se busca.
+   hilos cuenta los creados y an no esperados: si no hay ninguno, el
+   nico que puede tener un lote abierto es quien llama */
+static anillo_llamadas *lotes[PAGINA_MAX_PROC];
+static int lotes_abiertos=0;
+static int hilos=0;
+
+int id_en_pagina();
+
+/*
+ * Produce la interrupcin de llamada al sistema con los registros dados
+ */
+static void trampa(long *registros){
+	union sigval valor;
+
+	valor.sival_ptr=registros;
+	pthread_sigqueue(pthread_self(), SENAL_LLAMSIS, valor);
+}
+
+/*
+ * Identificador del proceso o hilo que llama. Se toma de la pgina de
+ * datos si la hay y slo hay un procesador; si no, se pide al kernel
+ * sin pasar por llamsis, que lo usa para encontrar el lote.
+ */
+static int id_llamante(){
+	long registros[NREGS];
+	int id;
+
+	if ((id=id_en_pagina())>=0)
+		return id;
+	memset(registros, 0, sizeof(registros));
+	registros[0]=OBTENER_ID_PR;
+	trampa(registros);
+	return (int)registros[0];
+}
+
+/*
+ * Posicin del lote que prepara quien llama, o -1. Sin hilos se busca el
+ * nico abierto, sin tener que identificar a quien llama.
+ */
+static int pos_lote_actual(){
+	int i;
+
+	if (__atomic_load_n(&lotes_abiertos, __ATOMIC_ACQUIRE)==0)
+		return -1;
+	if (__atomic_load_n(&hilos, __ATOMIC_ACQUIRE)>0)
+		return lotes[i=id_llamante()]!=NULL ? i : -1;
+	for (i=0; i<PAGINA_MAX_PROC; i++)
+		if (lotes[i]!=NULL)
+			return i;
+	return -1;
+}
+
+static anillo_llamadas *lote_actual(){
+	int pos=pos_lote_actual();
+
+	return pos<0 ? NULL : lotes[pos];
+}
+
+/*
+ * Aade la llamada al anillo del lote y devuelve su nmero de orden
+ */
+static int encolar_llamada(anillo_llamadas *lote, long *registros){
+	unsigned int cola=lote->cola_peticiones;
+	peticion_lote *peticion;
+	int i;
+
+	if (cola-__atomic_load_n(&lote->cab_peticiones, __ATOMIC_ACQUIRE)==
+			TAM_ANILLO)
+		return -1;
+	peticion=&lote->peticiones[cola%TAM_ANILLO];
+	peticion->servicio=registros[0];
+	for (i=1; i<NREGS; i++)
+		peticion->param[i-1]=registros[i];
+	peticion->dato=cola;
+	__atomic_store_n(&lote->cola_peticiones, cola+1, __ATOMIC_RELEASE);
+	return (int)(cola&0x7fffffff);
+}
+
+/*
+ * Prepara el cdigo de la llamada (en el registro 0) y los parmetros
+ * (en registros 1, 2, ...), produce la interrupcin de llamada al sistema
+ * y devuelve el resultado (que obtiene del registro 0). Mientras se
+ * prepara un lote, la llamada slo se encola.
+ */
+int llamsis(int llamada, int nargs, ... /* args */){
+	anillo_llamadas *lote;
+	long registros[NREGS];
+	va_list args;
+	int i;
+
+	memset(registros, 0, sizeof(registros));
+	registros[0]=llamada;
+	va_start(args, nargs);
+	for (i=1; i<=nargs && i<NREGS; i++)
+		registros[i]=va_arg(args, long);
+	va_end(args);
+
+	if ((lote=lote_actual())!=NULL)
+		return encolar_llamada(lote, registros);
+
+	trampa(registros);
+	return (int)registros[0];
+}
+
+/*
+ * Indica a pagina.c que las llamadas slo se estn encolando
+ */
+int preparando_lote(){
+	return lote_actual()!=NULL;
+}
+
+static void olvidar_lote(int id){
+	if (id>=0 && id<PAGINA_MAX_PROC && lotes[id]!=NULL) {
+		lotes[id]=NULL;
+		__atomic_fetch_sub(&lotes_abiertos, 1, __ATOMIC_RELEASE);
+	}
+}
+
+/*
+ * Las invocan crear_hilo, antes de crearlo, y esperar_hilo, que olvida
+ * el lote que el hilo dejara a medias antes de que su identificador se
+ * reutilice
+ */
+void hilo_creado(int creado){
+	__atomic_fetch_add(&hilos, creado ? 1 : -1, __ATOMIC_RELEASE);
+}
+
+void hilo_esperado(int id){
+	olvidar_lote(id);
+	__atomic_fetch_sub(&hilos, 1, __ATOMIC_RELEASE);
+}
+
+void iniciar_anillo(anillo_llamadas *anillo){
+	memset(anillo, 0, sizeof(*anillo));
+}
+
+/*
+ * obtener_id_pr obtiene adems la pgina de datos, para que identificar
+ * a quien llama no cueste una llamada con un procesador
+ */
+void preparar_lote(anillo_llamadas *anillo){
+	int id=obtener_id_pr();
+
+	if (id<0 || id>=PAGINA_MAX_PROC)
+		return;
+	if (lotes[id]==NULL)
+		__atomic_fetch_add(&lotes_abiertos, 1, __ATOMIC_RELEASE);
+	lotes[id]=anillo;
+}
+
+/*
+ * Deja de encolar y enva lo pendiente. Los textos de printf se pueden
+ * reutilizar cuando no queda ninguna peticin por ejecutar.
+ */
+int enviar_lote(){
+	int pos=pos_lote_actual();
+	anillo_llamadas *anillo;
+	int res;
+
+	if (pos<0)
+		return 0;
+	anillo=lotes[pos];
+	olvidar_lote(pos);
+	res=procesar_lote(anillo);
+	if (anillo->cab_peticiones==anillo->cola_peticiones)
+		anillo->texto_usado=0;
+	return res;
+}
+
+int recoger_terminacion(anillo_llamadas *anillo, long *dato, int *resultado){
+	unsigned int cab=anillo->cab_terminaciones;
+	terminacion_lote *terminacion;
+
+	if (cab==__atomic_load_n(&anillo->cola_terminaciones, __ATOMIC_ACQUIRE))
+		return -1;
+	terminacion=&anillo->terminaciones[cab%TAM_ANILLO];
+	if (dato!=NULL)
+		*dato=terminacion->dato;
+	if (resultado!=NULL)
+		*resultado=terminacion->resultado;
+	__atomic_store_n(&anillo->cab_terminaciones, cab+1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/*
+ * Versin de printf que escribe mediante la llamada escribir. En un lote
+ * el texto se copia en el anillo, ya que buf deja de existir al volver.
+ */
+int escribirf(const char *formato, ...){
+	anillo_llamadas *lote=lote_actual();
+	char buf[TAM_BUF_ESCRIBIRF];
+	va_list args;
+	int n;
+
+	va_start(args, formato);
+	n=vsnprintf(buf, sizeof(buf), formato, args);
+	va_end(args);
+	if (n>=(int)sizeof(buf))
+		n=sizeof(buf)-1;
+	if (n<=0)
+		return n;
+	if (lote==NULL) {
+		escribir(buf, n);
+		return n;
+	}
+	if (lote->texto_usado+n>TAM_TEXTO_LOTE)
+		return -1;
+	memcpy(&lote->texto[lote->texto_usado], buf, n);
+	if (escribir(&lote->texto[lote->texto_usado], n)<0)
+		return -1;
+	lote->texto_usado+=n;
+	return n;
+}
@@ -0,0 +1,110 @@
+/*
+ *  usuario/lib/pagina.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ *
+ * Fichero que contiene las funciones que leen la pgina de datos del
+ * kernel en lugar de hacer una llamada al sistema: obtener_id_pr,
+ * tiempos_proceso y leer_pagina_datos. Si el kernel no ofrece la pgina
+ * se recurre a las llamadas.
+ *
+ */
+
+#include <stddef.h>
+
+#include "llamsis.h"
+#include "servicios.h"
+
+int llamsis(int llamada, int nargs, ... /* args */);
+int preparando_lote();
+
+/* Pgina de datos; cada proceso tiene su propia copia de la biblioteca */
+static const pagina_datos *pagina=NULL;
+static int sin_pagina=0;
+
+/*
+ * Obtiene la direccin de la pgina la primera vez que se usa (no
+ * mientras se prepara un lote, ya que la llamada slo se encolara)
+ */
+static const pagina_datos *obtener_pagina(){
+	void *dir;
+
+	if (pagina==NULL && !sin_pagina && !preparando_lote()) {
+		if (obtener_pagina_datos(&dir)==0)
+			pagina=dir;
+		else
+			sin_pagina=1;
+	}
+	return pagina;
+}
+
+/*
+ * Copia la pgina de forma coherente: si el contador de secuencia es
+ * impar o cambia durante la copia, el kernel la estaba actualizando y se
+ * vuelve a copiar
+ */
+static void copiar_pagina(const pagina_datos *p, pagina_datos *copia){
+	unsigned int secuencia;
+
+	for (;;) {
+		secuencia=__atomic_load_n(&p->secuencia, __ATOMIC_ACQUIRE);
+		if (secuencia&1)
+			continue;
+		*copia=*p;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&p->secuencia, __ATOMIC_RELAXED)==secuencia)
+			return;
+	}
+}
+
+int leer_pagina_datos(pagina_datos *copia){
+	const pagina_datos *p=obtener_pagina();
+
+	if (p==NULL)
+		return -1;
+	copiar_pagina(p, copia);
+	return 0;
+}
+
+/*
+ * Proceso en ejecucin segn la pgina, o -1 si no la hay o hay varios
+ * procesadores. No intenta obtener la pgina, ya que misc.c lo usa desde
+ * llamsis para saber qu lote prepara quien llama.
+ */
+int id_en_pagina(){
+	if (pagina==NULL || pagina->procesadores>1)
+		return -1;
+	return pagina->id_actual;
+}
+
+/*
+ * Con varios procesadores la pgina no indica en cul se ejecuta el
+ * proceso, por lo que se hace la llamada
+ */
+int obtener_id_pr(){
+	const pagina_datos *p=obtener_pagina();
+
+	if (p==NULL || p->procesadores>1)
+		return llamsis(OBTENER_ID_PR, 0);
+	return p->id_actual;
+}
+
+int tiempos_proceso(struct tiempos_ejec *t_ejec){
+	const pagina_datos *p=obtener_pagina();
+	pagina_datos copia;
+
+	if (p==NULL || (t_ejec!=NULL && p->procesadores>1))
+		return llamsis(TIEMPOS_PROCESO, 1, (long)t_ejec);
+	if (t_ejec==NULL)
+		return __atomic_load_n(&p->ticks, __ATOMIC_ACQUIRE);
+
+	copiar_pagina(p, &copia);
+	*t_ejec=copia.tiempos[copia.id_actual];
+	return copia.ticks;
+}
@@ -26,6 +26,12 @@
 
 int llamsis(int llamada, int nargs, ... /* args */);
 
+/* Funciones del mdulo "misc" que llevan la cuenta de los hilos, para
+   saber a quin pertenece cada lote */
+void hilo_creado(int creado);
+void hilo_esperado(int id);
+int preparando_lote();
+
 
 /*
  *
@@ -38,22 +44,19 @@ int crear_proceso(char *prog){
 	return llamsis(CREAR_PROCESO, 1, (long)prog);
 }
 int terminar_proceso(){
-	return llamsis(TERMINAR_PROCESO, 0);
+	/* valor de terminacin 0 para quien espere al hilo */
+	return llamsis(TERMINAR_PROCESO, 1, 0L);
 }
 int escribir(char *texto, unsigned int longi){
 	return llamsis(ESCRIBIR, 2, (long)texto, (long)longi);
 }
 
 
-int obtener_id_pr(){
-	return llamsis(OBTENER_ID_PR,0);
-}
+/* obtener_id_pr y tiempos_proceso estn en pagina.c */
+
 int dormir(unsigned int segundos){
 	return llamsis(DORMIR, 1, (long)segundos);
 }
-int tiempos_proceso(struct tiempos_ejec *t_ejec){
-	return llamsis(TIEMPOS_PROCESO, 1, (long) t_ejec);
-}
 int crear_mutex(char *nombre, int tipo){
 	return llamsis(CREAR_MUTEX, 2, (long) nombre, (long) tipo);
 }
@@ -71,4 +74,171 @@ int cerrar_mutex(unsigned int mutexid){
 }
 int leer_caracter(){
 	return llamsis(LEER_CARACTER,0);
+}
+int crear_semaforo(char *nombre, int valor){
+	return llamsis(CREAR_SEMAFORO, 2, (long) nombre, (long) valor);
+}
+int abrir_semaforo(char *nombre){
+	return llamsis(ABRIR_SEMAFORO, 1, (long)nombre);
+}
+int esperar_semaforo(unsigned int semid){
+	return llamsis(ESPERAR_SEMAFORO, 1, (long)semid);
+}
+int intentar_semaforo(unsigned int semid){
+	return llamsis(INTENTAR_SEMAFORO, 1, (long)semid);
+}
+int senalar_semaforo(unsigned int semid){
+	return llamsis(SENALAR_SEMAFORO, 1, (long)semid);
+}
+int cerrar_semaforo(unsigned int semid){
+	return llamsis(CERRAR_SEMAFORO, 1, (long)semid);
+}
+int crear_condicion(char *nombre){
+	return llamsis(CREAR_CONDICION, 1, (long)nombre);
+}
+int abrir_condicion(char *nombre){
+	return llamsis(ABRIR_CONDICION, 1, (long)nombre);
+}
+int esperar_condicion(unsigned int condid, unsigned int mutexid){
+	return llamsis(ESPERAR_CONDICION, 2, (long)condid, (long)mutexid);
+}
+int senalar_condicion(unsigned int condid){
+	return llamsis(SENALAR_CONDICION, 1, (long)condid);
+}
+int difundir_condicion(unsigned int condid){
+	return llamsis(DIFUNDIR_CONDICION, 1, (long)condid);
+}
+int cerrar_condicion(unsigned int condid){
+	return llamsis(CERRAR_CONDICION, 1, (long)condid);
+}
+int futex_esperar(int *dir, int valor){
+	return llamsis(FUTEX_ESPERAR, 2, (long)dir, (long)valor);
+}
+int futex_despertar(int *dir, int num){
+	return llamsis(FUTEX_DESPERTAR, 2, (long)dir, (long)num);
+}
+int crear_memoria(char *nombre, unsigned int tam, void **dir){
+	return llamsis(CREAR_MEMORIA, 3, (long)nombre, (long)tam, (long)dir);
+}
+int asociar_memoria(char *nombre, void **dir){
+	return llamsis(ASOCIAR_MEMORIA, 2, (long)nombre, (long)dir);
+}
+int desasociar_memoria(unsigned int memid){
+	return llamsis(DESASOCIAR_MEMORIA, 1, (long)memid);
+}
+int crear_cola(char *nombre, int num_mensajes, int tam_mensaje){
+	return llamsis(CREAR_COLA, 3, (long)nombre, (long)num_mensajes,
+		(long)tam_mensaje);
+}
+int abrir_cola(char *nombre){
+	return llamsis(ABRIR_COLA, 1, (long)nombre);
+}
+int enviar_cola(unsigned int colaid, void *mensajes, int num, int bloqueante){
+	return llamsis(ENVIAR_COLA, 4, (long)colaid, (long)mensajes, (long)num,
+		(long)bloqueante);
+}
+int recibir_cola(unsigned int colaid, void *mensajes, int num, int bloqueante){
+	return llamsis(RECIBIR_COLA, 4, (long)colaid, (long)mensajes, (long)num,
+		(long)bloqueante);
+}
+int cerrar_cola(unsigned int colaid){
+	return llamsis(CERRAR_COLA, 1, (long)colaid);
+}
+int esperar_eventos(evento *eventos, int num, int plazo_ms){
+	return llamsis(ESPERAR_EVENTOS, 3, (long)eventos, (long)num,
+		(long)plazo_ms);
+}
+int dormir_ticks(unsigned int ticks){
+	return llamsis(DORMIR_TICKS, 1, (long)ticks);
+}
+int dormir_hasta(int tick){
+	return llamsis(DORMIR_HASTA, 1, (long)tick);
+}
+int crear_temporizador(char *nombre, int periodo_ticks){
+	return llamsis(CREAR_TEMPORIZADOR, 2, (long)nombre, (long)periodo_ticks);
+}
+int abrir_temporizador(char *nombre){
+	return llamsis(ABRIR_TEMPORIZADOR, 1, (long)nombre);
+}
+int esperar_temporizador(unsigned int tmpid){
+	return llamsis(ESPERAR_TEMPORIZADOR, 1, (long)tmpid);
+}
+int cerrar_temporizador(unsigned int tmpid){
+	return llamsis(CERRAR_TEMPORIZADOR, 1, (long)tmpid);
+}
+int fijar_tiempo_real(int periodo, int presupuesto){
+	return llamsis(FIJAR_TIEMPO_REAL, 2, (long)periodo, (long)presupuesto);
+}
+int esperar_periodo(){
+	return llamsis(ESPERAR_PERIODO, 0);
+}
+int fijar_planificacion(int politica){
+	return llamsis(FIJAR_PLANIFICACION, 1, (long)politica);
+}
+int fijar_billetes(int billetes){
+	return llamsis(FIJAR_BILLETES, 1, (long)billetes);
+}
+int obtener_pagina_datos(void **dir){
+	return llamsis(OBTENER_PAGINA_DATOS, 1, (long)dir);
+}
+int procesar_lote(anillo_llamadas *anillo){
+	return llamsis(PROCESAR_LOTE, 1, (long)anillo);
+}
+int dormir_asinc(unsigned int segundos){
+	return llamsis(DORMIR_ASINC, 1, (long)segundos);
+}
+int leer_caracter_asinc(){
+	return llamsis(LEER_CARACTER_ASINC, 0);
+}
+int lock_asinc(unsigned int mutexid){
+	return llamsis(LOCK_ASINC, 1, (long)mutexid);
+}
+int esperar_terminaciones(terminacion_asinc *terminaciones, int num,
+	int bloqueante){
+	return llamsis(ESPERAR_TERMINACIONES, 3, (long)terminaciones, (long)num,
+		(long)bloqueante);
+}
+int obtener_estad_memoria(estad_memoria *estad){
+	return llamsis(OBTENER_ESTAD_MEMORIA, 1, (long)estad);
+}
+int crear_grupo(){
+	return llamsis(CREAR_GRUPO, 0);
+}
+int senalar_grupo(int grupo, int accion){
+	return llamsis(SENALAR_GRUPO, 2, (long)grupo, (long)accion);
+}
+int fijar_cuota_grupo(int grupo, int cuota, int periodo){
+	return llamsis(FIJAR_CUOTA_GRUPO, 3, (long)grupo, (long)cuota,
+		(long)periodo);
+}
+int obtener_estad_cuota(int grupo, estad_cuota *estad){
+	return llamsis(OBTENER_ESTAD_CUOTA, 2, (long)grupo, (long)estad);
+}
+int obtener_estad_carga(estad_carga *estad){
+	return llamsis(OBTENER_ESTAD_CARGA, 1, (long)estad);
+}
+int leer_parametro(char *nombre){
+	return llamsis(LEER_PARAMETRO, 1, (long)nombre);
+}
+int fijar_parametro(char *nombre, int valor){
+	return llamsis(FIJAR_PARAMETRO, 2, (long)nombre, (long)valor);
+}
+int crear_hilo(int (*funcion)(void *), void *arg){
+	int id;
+
+	hilo_creado(1);
+	if ((id=llamsis(CREAR_HILO, 2, (long)funcion, (long)arg))<0)
+		hilo_creado(0);
+	return id;
+}
+int terminar_hilo(int valor){
+	return llamsis(TERMINAR_PROCESO, 1, (long)valor);
+}
+int esperar_hilo(int id, int *valor){
+	int res=llamsis(ESPERAR_HILO, 2, (long)id, (long)valor);
+
+	/* encolada en un lote, slo devuelve su nmero de orden */
+	if (res==0 && !preparando_lote())
+		hilo_esperado(id);
+	return res;
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*
+ * usuario/memoria1.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de una prueba de la memoria
+ * compartida
+ *
+ */
+
+#include "servicios.h"
+
+#define ITER 200000	/* debe coincidir con prueba_memoria */
+
+struct datos {
+	cerrojo c;
+	int cuenta;
+};
+
+int main(){
+	struct datos *d;
+	void *p;
+	int desc, fin, i, j, valor;
+
+	if ((desc=asociar_memoria("z1", &p))<0)
+		printf("error asociando z1. NO DEBE APARECER\n");
+	d=p;
+
+	if ((fin=abrir_semaforo("fin"))<0)
+		printf("error abriendo fin. NO DEBE APARECER\n");
+
+	printf("memoria1 (%d) incrementa la cuenta compartida\n",
+		obtener_id_pr());
+
+	for (i=0; i<ITER; i++) {
+		adquirir_cerrojo(&d->c);
+		valor=d->cuenta;
+		for (j=0; j<10; j++);	/* agranda la seccin crtica */
+		d->cuenta=valor+1;
+		liberar_cerrojo(&d->c);
+	}
+
+	desasociar_memoria(desc);
+	senalar_semaforo(fin);
+	return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * usuario/prueba_asinc.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las llamadas asncronas: con un solo
+ * proceso tiene pendientes a la vez un lock sobre un mutex que tiene
+ * asinc1, un dormir y varias lecturas del terminal, y las atiende segn
+ * se completan. Comprueba tambin que una lectura asncrona no se lleva
+ * el carcter de asinc2, una lectura sncrona ya despertada que an no
+ * ha vuelto a ejecutar.
+ *
+ */
+
+#include "servicios.h"
+
+#define LECTURAS 3
+
+int main(){
+	terminacion_asinc t[MAX_ASINC_PROC];
+	int mut, tok_lock, tok_dormir, i, n, pendientes, recogidas;
+	int cola, aviso, leyendo, t0;
+	char car;
+
+	printf("prueba_asinc comienza\n");
+
+	if ((mut=crear_mutex("masinc", NO_RECURSIVO))<0)
+		printf("error creando mutex. NO DEBE APARECER\n");
+
+	if (lock_asinc(99)<0)
+		printf("descriptor no vlido rechazado. DEBE APARECER\n");
+
+	if (esperar_terminaciones(t, MAX_ASINC_PROC, BLOQUEANTE)==0)
+		printf("sin peticiones no se bloquea. DEBE APARECER\n");
+
+	/* las pendientes ms las no recogidas estn limitadas */
+	for (i=0; i<MAX_ASINC_PROC; i++)
+		dormir_asinc(0);
+	if (dormir_asinc(0)<0)
+		printf("lmite de peticiones por proceso. DEBE APARECER\n");
+	for (recogidas=0; recogidas<MAX_ASINC_PROC; )
+		recogidas+=esperar_terminaciones(t, MAX_ASINC_PROC, BLOQUEANTE);
+	printf("recogidas %d terminaciones de dormir\n", recogidas);
+
+	/* asinc1 se queda con el mutex durante 2 segundos */
+	if (crear_proceso("asinc1")<0)
+		printf("Error creando asinc1\n");
+	dormir_ticks(1);
+
+	tok_lock=lock_asinc(mut);
+	if (lock_asinc(mut)==-2)
+		printf("segundo lock sobre mutex no recursivo rechazado. DEBE APARECER\n");
+	tok_dormir=dormir_asinc(1);
+	for (i=0; i<LECTURAS; i++)
+		leer_caracter_asinc();
+
+	/* atiende las terminaciones segn llegan */
+	for (pendientes=LECTURAS+2; pendientes>0; pendientes-=n) {
+		n=esperar_terminaciones(t, MAX_ASINC_PROC, BLOQUEANTE);
+		for (i=0; i<n; i++) {
+			if (t[i].testigo==tok_lock)
+				printf("prueba_asinc obtiene el mutex (%d)\n",
+					t[i].resultado);
+			else if (t[i].testigo==tok_dormir)
+				printf("prueba_asinc termina de dormir\n");
+			else
+				printf("prueba_asinc lee el carcter %c\n",
+					t[i].resultado);
+		}
+	}
+
+	if (unlock(mut)==0)
+		printf("prueba_asinc es propietario del mutex. DEBE APARECER\n");
+
+	/* asinc2 espera el aviso para leer */
+	if ((cola=crear_cola("casinc", 1, 1))<0 ||
+	    (aviso=crear_semaforo("sasinc", 0))<0 ||
+	    (leyendo=crear_semaforo("sasinc2", 0))<0)
+		printf("error creando cola o semforos. NO DEBE APARECER\n");
+	if (crear_proceso("asinc2")<0)
+		printf("Error creando asinc2\n");
+
+	/* vaca el buffer: la ltima lectura queda pendiente del siguiente
+	   carcter; tras el tick siguiente, del que tambin se lee el
+	   carcter, quedan llamadas de sobra antes de otro */
+	do
+		leer_caracter_asinc();
+	while (esperar_terminaciones(t, 1, NO_BLOQUEANTE)==1);
+	esperar_terminaciones(t, 1, BLOQUEANTE);
+	for (t0=tiempos_proceso(0); tiempos_proceso(0)==t0; )
+		;
+	leer_caracter_asinc();
+	esperar_terminaciones(t, 1, BLOQUEANTE);
+
+	/* asinc2 se bloquea leyendo y el carcter del siguiente tick lo
+	   despierta; antes de que vuelva a ejecutar se pide otro */
+	senalar_semaforo(aviso);
+	esperar_semaforo(leyendo);
+	for (t0=tiempos_proceso(0); tiempos_proceso(0)==t0; )
+		;
+	leer_caracter_asinc();
+	esperar_terminaciones(t, 1, BLOQUEANTE);
+	printf("prueba_asinc lee el carcter %c\n", t[0].resultado);
+	if (recibir_cola(cola, &car, 1, NO_BLOQUEANTE)==1)
+		printf("la lectura despertada conserva su carcter. DEBE APARECER\n");
+
+	printf("prueba_asinc termina\n");
+	return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * usuario/prueba_caches.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las caches de bloques del kernel: las
+ * zonas de segmentos y colas que se crean y se cierran repetidamente
+ * reutilizan los mismos bloques sin pedir ms memoria.
+ *
+ */
+
+#include "servicios.h"
+
+#define REPETICIONES 50
+
+static void imp_caches(estad_memoria *e){
+	int i;
+	estad_cache *c;
+
+	printf("arena %d de %d, heap %d\n", e->usado_arena, e->tam_arena,
+		e->tam_heap);
+	for (i=0; i<e->num_caches; i++) {
+		c=&e->caches[i];
+		if (c->reservas>0)
+			printf("cache %d: bloques %d usados %d max %d reservas %d fallos %d\n",
+				c->tam_bloque, c->bloques, c->usados,
+				c->max_usados, c->reservas, c->fallos);
+	}
+}
+
+int main(){
+	estad_memoria antes, despues;
+	void *dir;
+	int i, seg, cola;
+
+	printf("prueba_caches comienza\n");
+
+	obtener_estad_memoria(&antes);
+	if (antes.usado_arena==antes.tam_arena && antes.tam_heap==0)
+		printf("arena repartida entre las caches al arrancar. DEBE APARECER\n");
+
+	/* crear y cerrar repetidamente no consume ms memoria */
+	for (i=0; i<REPETICIONES; i++) {
+		seg=crear_memoria("mcache", 4000, &dir);
+		cola=crear_cola("qcache", 16, 100);
+		if (seg<0 || cola<0)
+			printf("error creando objetos. NO DEBE APARECER\n");
+		if (i==0)
+			((char *)dir)[0]=1;
+		desasociar_memoria(seg);
+		cerrar_cola(cola);
+	}
+	seg=crear_memoria("mcache", 4000, &dir);
+	if (((char *)dir)[0]==0)
+		printf("segmento reutilizado a cero. DEBE APARECER\n");
+	desasociar_memoria(seg);
+
+	/* un segmento grande obtiene su losa del heap una sola vez */
+	for (i=0; i<3; i++) {
+		seg=crear_memoria("mgrande", 1024*1024, &dir);
+		desasociar_memoria(seg);
+	}
+
+	obtener_estad_memoria(&despues);
+	imp_caches(&despues);
+	if (despues.tam_heap==1024*1024)
+		printf("slo una losa del heap. DEBE APARECER\n");
+
+	/* no se admite un nombre de mutex vaco */
+	if (crear_mutex("", NO_RECURSIVO)<0)
+		printf("nombre de mutex vaco rechazado. DEBE APARECER\n");
+
+	printf("prueba_caches termina\n");
+	return 0;
+}
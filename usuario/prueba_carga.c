@@ -0,0 +1,72 @@
+/*
+ * usuario/prueba_carga.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las cargas medias y la presin sobre la
+ * UCP: con dos procesos carga1 calculando ms que procesadores, la carga
+ * de 1 segundo se acerca a su nmero y hay presin casi todo el tiempo;
+ * al terminar ellos baja antes que la de 15 segundos.
+ *
+ */
+
+#include "servicios.h"
+
+#define PROCESOS_DE_MAS 2	/* sobre el nmero de procesadores */
+
+static void imp_carga(estad_carga *e){
+	printf("carga %d.%03d %d.%03d %d.%03d presion %d %d %d\n",
+		e->carga[0]/1000, e->carga[0]%1000,
+		e->carga[1]/1000, e->carga[1]%1000,
+		e->carga[2]/1000, e->carga[2]%1000,
+		e->presion[0], e->presion[1], e->presion[2]);
+}
+
+int main(){
+	estad_carga e;
+	pagina_datos p;
+	int *fin, i, procesos;
+
+	printf("prueba_carga comienza\n");
+
+	if (crear_memoria("scarga", sizeof(int), (void **)&fin)<0)
+		printf("error creando segmento. NO DEBE APARECER\n");
+
+	/* dormido no hay carga */
+	dormir(2);
+	obtener_estad_carga(&e);
+	imp_carga(&e);
+	if (e.carga[0]<200 && e.presion[0]==0)
+		printf("sistema sin carga. DEBE APARECER\n");
+
+	/* ms procesos calculando sin parar que procesadores */
+	procesos=PROCESOS_DE_MAS+(leer_pagina_datos(&p)==0 ? p.procesadores : 1);
+	for (i=0; i<procesos; i++)
+		if (crear_proceso("carga1")<0)
+			printf("error creando carga1. NO DEBE APARECER\n");
+	dormir(5);
+	obtener_estad_carga(&e);
+	imp_carga(&e);
+	if (e.ejecutables==procesos+1 && e.carga[0]>=procesos*1000-500)
+		printf("carga de 1 segundo cerca de %d. DEBE APARECER\n", procesos);
+	if (e.presion[0]>=900 && e.ticks_presion>0)
+		printf("procesos esperando UCP casi siempre. DEBE APARECER\n");
+	if (e.carga[2]<e.carga[1] && e.carga[1]<e.carga[0])
+		printf("las medias largas suben mas despacio. DEBE APARECER\n");
+
+	/* al terminar los procesos la media corta baja antes */
+	*fin=1;
+	dormir(3);
+	obtener_estad_carga(&e);
+	imp_carga(&e);
+	if (e.carga[0]<500 && e.carga[2]>e.carga[0])
+		printf("las medias largas bajan mas despacio. DEBE APARECER\n");
+
+	printf("prueba_carga termina\n");
+	return 0;
+}
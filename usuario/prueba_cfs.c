@@ -0,0 +1,62 @@
+/*
+ * usuario/prueba_cfs.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que compara round robin y CFS con un proceso
+ * interactivo, que duerme la mayor parte del tiempo, compitiendo con dos
+ * procesos cfs_carga que consumen toda la UCP. Mide cuntos ticks tarda
+ * el interactivo en ejecutar tras despertar: en round robin espera detrs
+ * de las rodajas de los dems; en CFS su menor tiempo virtual hace que
+ * se ejecute enseguida.
+ *
+ */
+
+#include "servicios.h"
+
+#define ITER 20
+#define DORMIR 5		/* ticks que duerme en cada iteracin */
+#define DURACION_CARGA 400	/* debe coincidir con cfs_carga */
+
+static int medir_latencia(){
+	int i, t, retraso, total=0;
+
+	for (i=0; i<ITER; i++) {
+		t=tiempos_proceso(0);
+		dormir_ticks(DORMIR);
+		retraso=tiempos_proceso(0)-t-DORMIR;
+		total+=retraso;
+	}
+	return total;
+}
+
+static void probar(int politica, char *nombre){
+	int total;
+
+	fijar_planificacion(politica);
+	if (crear_proceso("cfs_carga")<0 || crear_proceso("cfs_carga")<0)
+		printf("Error creando cfs_carga\n");
+
+	total=medir_latencia();
+	printf("prueba_cfs: %s: retraso medio al despertar %d.%d ticks\n",
+		nombre, total/ITER, (total*10/ITER)%10);
+
+	/* espera a que terminen los procesos de carga */
+	dormir_ticks(DURACION_CARGA);
+}
+
+int main(){
+	printf("prueba_cfs comienza\n");
+
+	probar(PLAN_RR, "round robin");
+	probar(PLAN_CFS, "CFS");
+
+	fijar_planificacion(PLAN_RR);
+	printf("prueba_cfs termina\n");
+	return 0;
+}
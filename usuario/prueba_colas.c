@@ -0,0 +1,53 @@
+/*
+ * usuario/prueba_colas.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de las colas de mensajes
+ *
+ */
+
+#include "servicios.h"
+
+#define HUECOS 4
+#define TAM_MENSAJE 16
+
+int main(){
+	char mensajes[HUECOS+2][TAM_MENSAJE];
+	int desc, i, n;
+
+	printf("prueba_colas comienza\n");
+
+	if (crear_cola("q0", 0, TAM_MENSAJE)<0)
+		printf("error creando cola sin huecos. DEBE APARECER\n");
+
+	if ((desc=crear_cola("q1", HUECOS, TAM_MENSAJE))<0)
+		printf("error creando q1. NO DEBE APARECER\n");
+
+	/* cola vaca: la recepcin no bloqueante no obtiene nada */
+	if (recibir_cola(desc, mensajes, 1, NO_BLOQUEANTE)==0)
+		printf("recepcin no bloqueante de cola vaca. DEBE APARECER\n");
+
+	/* slo caben HUECOS mensajes */
+	for (i=0; i<HUECOS+2; i++)
+		mensajes[i][0]='a'+i;
+	if ((n=enviar_cola(desc, mensajes, HUECOS+2, NO_BLOQUEANTE))==HUECOS)
+		printf("envo no bloqueante de %d mensajes a cola de %d huecos enva %d. DEBE APARECER\n",
+			HUECOS+2, HUECOS, n);
+
+	if (crear_proceso("cola1")<0)
+		printf("Error creando cola1\n");
+
+	/* la cola est llena: se bloquea hasta que cola1 recibe */
+	printf("prueba_colas enva 2 mensajes con la cola llena: se bloquear\n");
+	if (enviar_cola(desc, mensajes[HUECOS], 2, BLOQUEANTE)!=2)
+		printf("error en envo bloqueante. NO DEBE APARECER\n");
+
+	printf("prueba_colas ha enviado todos los mensajes y termina\n");
+	return 0;
+}
@@ -0,0 +1,59 @@
+/*
+ * usuario/prueba_condiciones.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de las condiciones
+ *
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mut, cond, i;
+
+	printf("prueba_condiciones comienza\n");
+
+	if ((mut=crear_mutex("mc", NO_RECURSIVO))<0)
+		printf("error creando mc. NO DEBE APARECER\n");
+
+	if ((cond=crear_condicion("c1"))<0)
+		printf("error creando c1. NO DEBE APARECER\n");
+
+	/* esperar sin tener el mutex -> error */
+	if (esperar_condicion(cond, mut)<0)
+		printf("esperar_condicion sin tener el mutex. DEBE APARECER\n");
+
+	for (i=1; i<=3; i++)
+		if (crear_proceso("condicion1")<0)
+			printf("Error creando condicion1\n");
+
+	printf("prueba_condiciones duerme 1 seg.: los procesos condicion1 esperarn en c1\n");
+	dormir(1);
+
+	if (lock(mut)<0)
+		printf("error en lock de mutex. NO DEBE APARECER\n");
+
+	if (senalar_condicion(cond)<0)
+		printf("error en senalar_condicion. NO DEBE APARECER\n");
+
+	printf("prueba_condiciones seala c1 con el mutex bloqueado: el primer condicion1 no ejecutar hasta el unlock\n");
+	dormir(1);
+
+	if (unlock(mut)<0)
+		printf("error en unlock de mutex. NO DEBE APARECER\n");
+
+	printf("prueba_condiciones duerme 1 seg.: debe ejecutar el primer condicion1\n");
+	dormir(1);
+
+	if (difundir_condicion(cond)<0)
+		printf("error en difundir_condicion. NO DEBE APARECER\n");
+
+	printf("prueba_condiciones difunde c1 y termina: deben ejecutar los otros dos condicion1 en orden de llegada\n");
+	return 0;
+}
@@ -0,0 +1,234 @@
+/*
+ * usuario/prueba_corrutinas.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las corrutinas de biblioteca: el turno
+ * al ceder, el orden al despertar, que las esperas al terminal y a un
+ * mutex slo detienen a la corrutina, el mutex compartido por corrutinas
+ * de varios hilos, el reparto entre varios hilos, el lmite de la tabla y
+ * que una llamada que necesita mucha pila, como crear_proceso, no pisa la
+ * pila de la corrutina contigua. En x86-64 comprueba adems que el modo
+ * de redondeo de una corrutina no pasa a otra.
+ *
+ */
+
+#include "servicios.h"
+
+#define TURNOS 3
+#define LECTORAS 2
+#define LECTURAS 3
+#define REPARTIDAS 100
+#define HILOS 2
+#define EN_MUTEX 4	/* corrutinas que se turnan en el mutex entre hilos */
+#define TAM_MARCA 8192	/* marca en la pila de la corrutina contigua */
+
+static int contador;
+static int leidas;
+static int por_hilo[PAGINA_MAX_PROC];
+static int mut;
+static int dentro, solapes, cerrojos;
+static int creado, marca_intacta;
+static int redondeo_propio, redondeo_ajeno;
+
+#ifdef __x86_64__
+#define REDONDEO_MXCSR 0x6000	/* hacia cero */
+#define REDONDEO_X87 0x0c00
+
+static unsigned short leer_control_x87(){
+	unsigned short control;
+
+	__asm__ volatile("fnstcw %0" : "=m"(control));
+	return control;
+}
+
+static void fijar_control_x87(unsigned short control){
+	__asm__ volatile("fldcw %0" : : "m"(control));
+}
+
+/* Cambia su modo de redondeo y comprueba que lo conserva tras ceder */
+static void cambia_redondeo(void *arg){
+	unsigned int mxcsr=__builtin_ia32_stmxcsr();
+	unsigned short control=leer_control_x87();
+
+	__builtin_ia32_ldmxcsr(mxcsr|REDONDEO_MXCSR);
+	fijar_control_x87(control|REDONDEO_X87);
+	ceder_corrutina();
+	redondeo_propio=(__builtin_ia32_stmxcsr()&REDONDEO_MXCSR)==REDONDEO_MXCSR &&
+		(leer_control_x87()&REDONDEO_X87)==REDONDEO_X87;
+	__builtin_ia32_ldmxcsr(mxcsr);
+	fijar_control_x87(control);
+}
+
+/* Empieza con el redondeo por defecto aunque otra lo haya cambiado */
+static void observa_redondeo(void *arg){
+	redondeo_ajeno=(__builtin_ia32_stmxcsr()&REDONDEO_MXCSR)==0 &&
+		(leer_control_x87()&REDONDEO_X87)==0;
+}
+#endif
+
+/* Deja una marca en su pila mientras la siguiente crea un proceso */
+static void con_marca(void *arg){
+	char marca[TAM_MARCA];
+	int i;
+
+	for (i=0; i<TAM_MARCA; i++)
+		marca[i]='M';
+	ceder_corrutina();
+	for (i=0; i<TAM_MARCA && marca[i]=='M'; i++)
+		;
+	marca_intacta=(i==TAM_MARCA);
+}
+
+static void creadora(void *arg){
+	creado=(crear_proceso("simplon")>=0);
+}
+
+static void turnos(void *arg){
+	int i;
+
+	for (i=0; i<TURNOS; i++) {
+		printf("corrutina %c turno %d\n", (int)(long)arg, i);
+		ceder_corrutina();
+	}
+}
+
+static void dormilona(void *arg){
+	dormir_corrutina((long)arg);
+	printf("corrutina despierta tras %d ticks\n", (int)(long)arg);
+}
+
+static void lectora(void *arg){
+	int i, car;
+
+	for (i=0; i<LECTURAS; i++) {
+		car=leer_caracter_corrutina();
+		printf("corrutina %d lee el carcter %c\n", (int)(long)arg, car);
+	}
+	leidas++;
+}
+
+static void contadora(void *arg){
+	while (leidas<LECTORAS) {
+		contador++;
+		obtener_id_pr();
+		ceder_corrutina();
+	}
+}
+
+static void con_mutex(void *arg){
+	lock_corrutina(mut);
+	printf("corrutina %d obtiene el mutex\n", (int)(long)arg);
+	dormir_corrutina(5);
+	printf("corrutina %d suelta el mutex\n", (int)(long)arg);
+	unlock_corrutina(mut);
+}
+
+/* Cuenta las veces que entra y si alguna vez hay otra dentro */
+static void exclusion(void *arg){
+	if (lock_corrutina(mut)<0)
+		return;
+	if (++dentro>1)
+		solapes++;
+	cerrojos++;
+	dormir_corrutina(2);
+	dentro--;
+	unlock_corrutina(mut);
+}
+
+static void anotar_hilo(void *arg){
+	por_hilo[obtener_id_pr()]++;
+	ceder_corrutina();
+}
+
+static void vacia(void *arg){
+}
+
+int main(){
+	int i, n, hilos;
+
+	printf("prueba_corrutinas comienza\n");
+
+	if (ejecutar_corrutinas(0)<0 && ejecutar_corrutinas(MAX_TRABAJADORES+1)<0)
+		printf("nmero de hilos no vlido rechazado. DEBE APARECER\n");
+
+	/* las dos primeras tienen pilas contiguas: la llamada de la segunda
+	   se trata en su pila, justo encima de la marca de la primera */
+	crear_corrutina(con_marca, 0);
+	crear_corrutina(creadora, 0);
+	ejecutar_corrutinas(1);
+	if (creado && marca_intacta)
+		printf("crear_proceso no pisa la pila contigua. DEBE APARECER\n");
+
+	/* ceder da paso a la siguiente en orden de llegada */
+	for (i=0; i<3; i++)
+		crear_corrutina(turnos, (void *)(long)('A'+i));
+	ejecutar_corrutinas(1);
+
+	/* despiertan por orden de plazo */
+	crear_corrutina(dormilona, (void *)30L);
+	crear_corrutina(dormilona, (void *)10L);
+	crear_corrutina(dormilona, (void *)20L);
+	ejecutar_corrutinas(1);
+
+	/* mientras unas esperan al terminal, la otra sigue ejecutando */
+	for (i=0; i<LECTORAS; i++)
+		crear_corrutina(lectora, (void *)(long)i);
+	crear_corrutina(contadora, 0);
+	ejecutar_corrutinas(1);
+	if (contador>LECTORAS*LECTURAS)
+		printf("la espera al terminal slo detiene a la corrutina. DEBE APARECER\n");
+
+	/* dos corrutinas del mismo hilo se turnan en un mutex del kernel */
+	if ((mut=crear_mutex("mcorr", NO_RECURSIVO))<0)
+		printf("error creando mutex. NO DEBE APARECER\n");
+	crear_corrutina(con_mutex, (void *)1L);
+	crear_corrutina(con_mutex, (void *)2L);
+	ejecutar_corrutinas(1);
+
+	/* el mismo mutex entre corrutinas de varios hilos, que heredan el
+	   descriptor del proceso */
+	for (i=0; i<EN_MUTEX; i++)
+		crear_corrutina(exclusion, 0);
+	ejecutar_corrutinas(HILOS);
+	if (cerrojos==EN_MUTEX && solapes==0)
+		printf("el mutex excluye a corrutinas de varios hilos. DEBE APARECER\n");
+
+#ifdef __x86_64__
+	/* el estado de coma flotante es de cada corrutina */
+	crear_corrutina(cambia_redondeo, 0);
+	crear_corrutina(observa_redondeo, 0);
+	ejecutar_corrutinas(1);
+	if (redondeo_propio && redondeo_ajeno)
+		printf("el modo de redondeo es de cada corrutina. DEBE APARECER\n");
+#endif
+
+	/* reparto entre varios hilos */
+	for (i=0; i<REPARTIDAS; i++)
+		crear_corrutina(anotar_hilo, 0);
+	ejecutar_corrutinas(HILOS);
+	for (i=hilos=n=0; i<PAGINA_MAX_PROC; i++)
+		if (por_hilo[i]) {
+			hilos++;
+			n+=por_hilo[i];
+		}
+	if (hilos==HILOS && n==REPARTIDAS)
+		printf("las corrutinas se reparten entre los hilos. DEBE APARECER\n");
+
+	/* la tabla se llena y se recicla */
+	for (n=0; crear_corrutina(vacia, 0)>=0; n++)
+		;
+	if (n==MAX_CORRUTINAS)
+		printf("lmite de corrutinas alcanzado. DEBE APARECER\n");
+	if (ejecutar_corrutinas(HILOS)==0 && crear_corrutina(vacia, 0)>=0 &&
+	    ejecutar_corrutinas(1)==0)
+		printf("corrutinas terminadas recicladas. DEBE APARECER\n");
+
+	printf("prueba_corrutinas termina\n");
+	return 0;
+}
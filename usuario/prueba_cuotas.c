@@ -0,0 +1,76 @@
+/*
+ * usuario/prueba_cuotas.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las cuotas de UCP de los grupos: limita
+ * al 20% el grupo de cuota1, que calcula sin parar, comprueba que no pasa
+ * de ah y que se estrangula en cada periodo, y vuelve a quitar el lmite.
+ *
+ */
+
+#include "servicios.h"
+
+#define CUOTA 2
+#define PERIODO 10
+#define SEGUNDOS 3
+
+struct estado_cuota {
+	int grupo;
+	int vueltas;
+};
+
+int main(){
+	struct estado_cuota *e;
+	estad_cuota estad;
+	int grupo, total, tps;
+
+	printf("prueba_cuotas comienza\n");
+	tps=ticks_por_segundo();
+
+	if (crear_memoria("scuota", sizeof(struct estado_cuota), (void **)&e)<0)
+		printf("error creando segmento. NO DEBE APARECER\n");
+	if (crear_proceso("cuota1")<0)
+		printf("error creando cuota1. NO DEBE APARECER\n");
+	dormir(1);
+	grupo=e->grupo;
+
+	/* sin cuota usa toda la UCP que deja libre prueba_cuotas */
+	obtener_estad_cuota(grupo, &estad);
+	if (estad.cuota==0 && estad.total>=tps/2)
+		printf("sin cuota usa la UCP libre. DEBE APARECER\n");
+
+	if (fijar_cuota_grupo(grupo, -1, PERIODO)<0 &&
+	    fijar_cuota_grupo(grupo, CUOTA, 0)<0 &&
+	    fijar_cuota_grupo(50, CUOTA, PERIODO)<0)
+		printf("cuotas no validas rechazadas. DEBE APARECER\n");
+
+	/* con cuota no pasa del 20% y se estrangula en cada periodo */
+	if (fijar_cuota_grupo(grupo, CUOTA, PERIODO)<0)
+		printf("error fijando cuota. NO DEBE APARECER\n");
+	dormir(SEGUNDOS);
+	obtener_estad_cuota(grupo, &estad);
+	total=SEGUNDOS*tps;
+	if (estad.total<=total*CUOTA/PERIODO+CUOTA)
+		printf("el grupo no supera su cuota. DEBE APARECER\n");
+	if (estad.veces_estrangulado>=total/PERIODO/2 &&
+	    estad.ticks_estrangulado>=total/2)
+		printf("el grupo se estrangula en cada periodo. DEBE APARECER\n");
+
+	/* sin lmite vuelve a usar toda la UCP */
+	if (fijar_cuota_grupo(grupo, 0, 0)<0)
+		printf("error quitando cuota. NO DEBE APARECER\n");
+	dormir(1);
+	obtener_estad_cuota(grupo, &estad);
+	if (estad.total>=tps/2 && !estad.estrangulado)
+		printf("sin cuota vuelve a usar la UCP libre. DEBE APARECER\n");
+
+	senalar_grupo(grupo, GRUPO_TERMINAR);
+	printf("prueba_cuotas termina\n");
+	return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * usuario/prueba_edf.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la planificacin de tiempo real EDF:
+ * arranca dos procesos de tiempo real (rt_rapido y rt_lento), comprueba el
+ * control de admisin y ocupa la UCP como proceso normal en el tiempo que
+ * le dejan.
+ *
+ */
+
+#include "servicios.h"
+
+#define DURACION 300	/* ticks que compite por la UCP */
+
+int main(){
+	struct tiempos_ejec t;
+	int t0;
+
+	printf("prueba_edf comienza\n");
+
+	if (fijar_tiempo_real(10, 20)<0)
+		printf("presupuesto mayor que el periodo. DEBE APARECER\n");
+
+	if (crear_proceso("rt_rapido")<0)
+		printf("Error creando rt_rapido\n");
+	if (crear_proceso("rt_lento")<0)
+		printf("Error creando rt_lento\n");
+
+	/* deja que se declaren de tiempo real (utilizacin 0.25 + 0.4) */
+	dormir_ticks(5);
+
+	if (fijar_tiempo_real(10, 5)==-2)
+		printf("no admitido con utilizacin 0.5. DEBE APARECER\n");
+
+	/* proceso normal que consume toda la UCP que queda libre */
+	t0=tiempos_proceso(0);
+	while (tiempos_proceso(0)<t0+DURACION);
+
+	tiempos_proceso(&t);
+	/* los procesos de tiempo real tienen reservado el 65% de la UCP */
+	printf("prueba_edf: %d ticks de UCP de %d. DEBEN SER AL MENOS %d\n",
+		t.usuario+t.sistema, DURACION, DURACION*35/100);
+	printf("prueba_edf termina\n");
+	return 0;
+}
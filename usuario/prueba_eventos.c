@@ -0,0 +1,87 @@
+/*
+ * usuario/prueba_eventos.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la espera de mltiples eventos: espera
+ * a la vez por el terminal, un semforo, una cola y un mutex con un solo
+ * proceso bloqueado. Los eventos los genera eventos1 y el teclado.
+ *
+ */
+
+#include "servicios.h"
+
+#define TAM_MENSAJE 8
+
+static char *nombres[]={"terminal", "mutex", "semforo", "cola"};
+
+int main(){
+	evento ev[4];
+	char mensaje[TAM_MENSAJE];
+	int sem, cola, mut, i, n, t, atendidos=0;
+
+	printf("prueba_eventos comienza\n");
+
+	if ((sem=crear_semaforo("sev", 0))<0 ||
+	    (cola=crear_cola("qev", 2, TAM_MENSAJE))<0 ||
+	    (mut=crear_mutex("mev", NO_RECURSIVO))<0)
+		printf("error creando objetos. NO DEBE APARECER\n");
+
+	ev[0].tipo=EV_TERMINAL;
+	ev[1].tipo=EV_MUTEX;		ev[1].desc=mut;
+	ev[2].tipo=EV_SEMAFORO;		ev[2].desc=sem;
+	ev[3].tipo=EV_COLA_RECIBIR;	ev[3].desc=cola;
+
+	/* el mutex est libre: el evento se produce sin esperar */
+	if (esperar_eventos(&ev[1], 1, 0)==1 && ev[1].listo)
+		printf("mutex libre listo. DEBE APARECER\n");
+
+	ev[1].desc=99;
+	if (esperar_eventos(ev, 4, 0)<0)
+		printf("descriptor no vlido rechazado. DEBE APARECER\n");
+	ev[1].desc=mut;
+
+	/* eventos1 bloquea el mutex mientras prueba_eventos espera el plazo
+	   por el semforo y la cola */
+	if (crear_proceso("eventos1")<0)
+		printf("Error creando eventos1\n");
+
+	t=tiempos_proceso(0);
+	n=esperar_eventos(&ev[2], 2, 500);
+	printf("vence plazo de 500 ms: devuelve %d tras %d ticks\n",
+		n, tiempos_proceso(0)-t);
+
+	/* atiende cada evento consumindolo para que deje de estar listo */
+	while (atendidos<4) {
+		n=esperar_eventos(ev, 4, SIN_PLAZO);
+		for (i=0; i<4; i++) {
+			if (!ev[i].listo)
+				continue;
+			printf("prueba_eventos: evento de %s\n", nombres[i]);
+			switch (ev[i].tipo) {
+			case EV_TERMINAL:
+				printf("ledo carcter %c\n", leer_caracter());
+				break;
+			case EV_MUTEX:
+				lock(mut);
+				break;
+			case EV_SEMAFORO:
+				esperar_semaforo(sem);
+				break;
+			case EV_COLA_RECIBIR:
+				recibir_cola(cola, mensaje, 1, NO_BLOQUEANTE);
+				printf("recibido mensaje %s\n", mensaje);
+				break;
+			}
+			atendidos++;
+		}
+	}
+
+	printf("prueba_eventos termina\n");
+	return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * usuario/prueba_grupos.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los grupos de procesos: suspende,
+ * reanuda y termina de una vez los tres procesos grupo1, comprobando que
+ * al terminar ceden el mutex que tenan bloqueado. Por ltimo termina su
+ * propio grupo, y con l a s mismo.
+ *
+ */
+
+#include "servicios.h"
+
+struct estado_grupo {
+	int grupo;
+	int vueltas;
+};
+
+int main(){
+	struct estado_grupo *e;
+	int mut, grupo, vueltas;
+
+	printf("prueba_grupos comienza\n");
+
+	if (crear_memoria("sgrupo", sizeof(struct estado_grupo), (void **)&e)<0)
+		printf("error creando segmento. NO DEBE APARECER\n");
+	if ((mut=crear_mutex("mgrupo", NO_RECURSIVO))<0)
+		printf("error creando mutex. NO DEBE APARECER\n");
+
+	if (crear_proceso("grupo1")<0)
+		printf("error creando grupo1. NO DEBE APARECER\n");
+	dormir(2);
+	grupo=e->grupo;
+
+	if (senalar_grupo(grupo, 7)<0)
+		printf("accion no valida rechazada. DEBE APARECER\n");
+
+	/* suspendido el grupo no avanza */
+	if (senalar_grupo(grupo, GRUPO_SUSPENDER)==3)
+		printf("suspendidos los 3 procesos del grupo. DEBE APARECER\n");
+	dormir(1);
+	vueltas=e->vueltas;
+	dormir(2);
+	if (e->vueltas==vueltas)
+		printf("el grupo suspendido no avanza. DEBE APARECER\n");
+
+	/* reanudado vuelve a avanzar */
+	if (senalar_grupo(grupo, GRUPO_REANUDAR)==3)
+		printf("reanudados los 3 procesos del grupo. DEBE APARECER\n");
+	dormir(2);
+	if (e->vueltas>vueltas)
+		printf("el grupo reanudado avanza. DEBE APARECER\n");
+
+	/* al terminar el grupo se libera el mutex que tena */
+	if (senalar_grupo(grupo, GRUPO_TERMINAR)==3)
+		printf("terminados los 3 procesos del grupo. DEBE APARECER\n");
+	lock(mut);
+	printf("mutex liberado al terminar el grupo. DEBE APARECER\n");
+	unlock(mut);
+	vueltas=e->vueltas;
+	dormir(2);
+	if (e->vueltas==vueltas)
+		printf("el grupo terminado no avanza. DEBE APARECER\n");
+	if (senalar_grupo(grupo, GRUPO_TERMINAR)<0)
+		printf("el grupo ya esta vacio. DEBE APARECER\n");
+
+	/* termina su propio grupo, y con l a s mismo */
+	grupo=crear_grupo();
+	printf("prueba_grupos termina con su grupo %d\n", grupo);
+	senalar_grupo(grupo, GRUPO_TERMINAR);
+
+	printf("prueba_grupos sigue tras terminar su grupo. NO DEBE APARECER\n");
+	return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * usuario/prueba_hilos.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los hilos: reparte una suma entre varios
+ * hilos que leen el mismo vector global y recoge sus resultados,
+ * comprueba los casos de error de esperar_hilo, que un hilo usa los
+ * descriptores de mutex de su creador y que el lote que prepara
+ * un hilo no recoge las llamadas de otro. Para esto ltimo el hilo que
+ * prepara el lote encola llamadas hasta que el otro ejecuta: en
+ * simulacin no hay pgina de datos, as que averiguar quin encola
+ * cuesta una llamada, el reloj avanza y se acaba su rodaja.
+ *
+ */
+
+#include "servicios.h"
+
+#define HILOS 4
+#define TAM 1000
+#define ENCOLADAS 10000	/* llamadas encoladas como mucho sin pgina */
+
+static int vector[TAM];
+static int vueltas[HILOS];
+
+static anillo_llamadas anillo;
+static volatile int lote_abierto, hecho;
+static int procesos, directa;
+
+static int sumar(void *arg){
+	int parte=(long)arg;
+	int i, suma=0;
+
+	for (i=parte*TAM/HILOS; i<(parte+1)*TAM/HILOS; i++) {
+		suma+=vector[i];
+		vueltas[parte]++;
+		if (i%100==0)
+			obtener_id_pr();
+	}
+	return suma;
+}
+
+/* Con el lote del otro hilo abierto, sus llamadas deben hacerse */
+static int fuera_del_lote(void *arg){
+	while (!lote_abierto)
+		dormir_ticks(1);
+	directa=(leer_parametro("procesos")==procesos);
+	hecho=1;
+	return 0;
+}
+
+/* Usa el descriptor de mutex que hereda de su creador */
+static int con_mutex_heredado(void *arg){
+	int desc=(long)arg;
+
+	if (lock(desc)<0 || unlock(desc)<0)
+		return -1;
+	return 0;
+}
+
+static int terminar_pronto(void *arg){
+	terminar_hilo(7);
+	printf("el hilo sigue tras terminar_hilo. NO DEBE APARECER\n");
+	return 0;
+}
+
+int main(){
+	int id[HILOS];
+	int i, n, valor, suma=0, total=0, otro, rodajas, t0, hay_pagina, desc;
+	pagina_datos pagina;
+
+	printf("prueba_hilos comienza\n");
+
+	for (i=0; i<TAM; i++) {
+		vector[i]=i;
+		total+=i;
+	}
+
+	for (i=0; i<HILOS; i++)
+		if ((id[i]=crear_hilo(sumar, (void *)(long)i))<0)
+			printf("error creando hilo. NO DEBE APARECER\n");
+	for (i=0; i<HILOS; i++) {
+		if (esperar_hilo(id[i], &valor)<0)
+			printf("error esperando hilo. NO DEBE APARECER\n");
+		suma+=valor;
+	}
+	if (suma==total)
+		printf("suma repartida entre los hilos correcta. DEBE APARECER\n");
+	for (i=0; i<HILOS && vueltas[i]==TAM/HILOS; i++)
+		;
+	if (i==HILOS)
+		printf("los hilos escriben en las variables del proceso. DEBE APARECER\n");
+
+	/* terminar_hilo fija el valor de terminacin */
+	otro=crear_hilo(terminar_pronto, 0);
+	if (esperar_hilo(otro, &valor)==0 && valor==7)
+		printf("valor de terminar_hilo recogido. DEBE APARECER\n");
+
+	if (esperar_hilo(otro, &valor)<0 && esperar_hilo(obtener_id_pr(), 0)<0 &&
+	    esperar_hilo(50, 0)<0)
+		printf("esperas no validas rechazadas. DEBE APARECER\n");
+
+	/* el hilo hereda los descriptores abiertos al crearlo */
+	desc=crear_mutex("mhilo", NO_RECURSIVO);
+	otro=crear_hilo(con_mutex_heredado, (void *)(long)desc);
+	if (esperar_hilo(otro, &valor)==0 && valor==0)
+		printf("el hilo usa el mutex de su creador. DEBE APARECER\n");
+	cerrar_mutex(desc);
+
+	/* el lote es de cada hilo: se deja abierto, encolando llamadas,
+	   hasta que el otro hilo ejecuta o pasan dos rodajas */
+	procesos=leer_parametro("procesos");
+	rodajas=2*leer_parametro("rodaja");
+	otro=crear_hilo(fuera_del_lote, 0);
+	iniciar_anillo(&anillo);
+	hay_pagina=(leer_pagina_datos(&pagina)==0);
+	preparar_lote(&anillo);
+	lote_abierto=1;
+	for (n=0, t0=pagina.ticks; !hecho; n++) {
+		obtener_id_pr();
+		if (hay_pagina && leer_pagina_datos(&pagina)==0 &&
+		    pagina.ticks-t0>=rodajas)
+			break;
+		if (!hay_pagina && n>=ENCOLADAS)
+			break;
+	}
+	enviar_lote();
+	if (esperar_hilo(otro, 0)==0 && directa)
+		printf("las llamadas de un hilo no entran en el lote de otro. DEBE APARECER\n");
+
+	printf("prueba_hilos termina\n");
+	return 0;
+}
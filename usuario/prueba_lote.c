@@ -0,0 +1,91 @@
+/*
+ * usuario/prueba_lote.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las llamadas por lotes: orden de
+ * ejecucin y resultados, anillos llenos, llamadas que bloquean dentro
+ * del lote y terminar_proceso en medio de un lote.
+ */
+
+#include "servicios.h"
+
+static anillo_llamadas anillo;
+
+/*
+ * Recoge e imprime todas las terminaciones pendientes
+ */
+static int recoger_todas(int imprimir){
+	long dato;
+	int res, n=0;
+
+	while (recoger_terminacion(&anillo, &dato, &res)==0) {
+		if (imprimir)
+			printf("terminacin %ld: resultado %d\n", dato, res);
+		n++;
+	}
+	return n;
+}
+
+int main(){
+	int i, n, t0;
+
+	printf("prueba_lote comienza\n");
+	iniciar_anillo(&anillo);
+
+	/* se ejecutan en orden y con sus resultados */
+	preparar_lote(&anillo);
+	printf("lote: primera lnea\n");
+	printf("lote: segunda lnea\n");
+	cerrar_mutex(99);	/* descriptor no vlido: -1 */
+	crear_semaforo("slote", 0);
+	n=enviar_lote();
+	printf("ejecutadas %d llamadas del lote. DEBEN SER 4\n", n);
+	recoger_todas(1);
+
+	/* con el anillo de peticiones lleno no se encolan ms */
+	preparar_lote(&anillo);
+	for (i=0; i<TAM_ANILLO; i++)
+		intentar_semaforo(0);
+	n=intentar_semaforo(0);
+	enviar_lote();
+	if (n<0)
+		printf("anillo de peticiones lleno. DEBE APARECER\n");
+
+	/* con el de terminaciones lleno la peticin queda pendiente */
+	preparar_lote(&anillo);
+	fijar_billetes(0);
+	n=enviar_lote();
+	printf("ejecutadas %d con terminaciones llenas. DEBE SER 0\n", n);
+	if (recoger_todas(0)==TAM_ANILLO)
+		printf("recogidas %d terminaciones\n", TAM_ANILLO);
+	preparar_lote(&anillo);
+	n=enviar_lote();
+	printf("ejecutadas %d al vaciarlas. DEBE SER 1\n", n);
+	recoger_todas(0);
+
+	/* una llamada que bloquea detiene el lote hasta que se despierta */
+	t0=tiempos_proceso(0);
+	preparar_lote(&anillo);
+	dormir_ticks(5);
+	printf("lote: tras dormir\n");
+	enviar_lote();
+	recoger_todas(0);
+	if (tiempos_proceso(0)-t0>=5)
+		printf("el lote espera a la llamada bloqueante. DEBE APARECER\n");
+
+	/* terminar_proceso no vuelve: lo que le sigue no se ejecuta */
+	preparar_lote(&anillo);
+	printf("lote: antes de terminar. DEBE APARECER\n");
+	terminar_proceso();
+	printf("lote: despus de terminar. NO DEBE APARECER\n");
+	enviar_lote();
+
+	printf("prueba_lote: NO DEBE APARECER\n");
+	return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * usuario/prueba_memoria.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de la memoria compartida:
+ * dos procesos memoria1 incrementan un contador en un segmento protegido
+ * por un cerrojo de biblioteca situado en el propio segmento.
+ *
+ */
+
+#include "servicios.h"
+
+#define ITER 200000	/* debe coincidir con memoria1 */
+
+struct datos {
+	cerrojo c;
+	int cuenta;
+};
+
+int main(){
+	struct datos *d;
+	void *p;
+	int desc, fin, i;
+
+	printf("prueba_memoria comienza\n");
+
+	if (crear_memoria("z0", 0, &p)<0)
+		printf("error creando segmento de tamao 0. DEBE APARECER\n");
+
+	if (asociar_memoria("noexiste", &p)<0)
+		printf("error asociando segmento inexistente. DEBE APARECER\n");
+
+	if ((desc=crear_memoria("z1", sizeof(struct datos), &p))<0)
+		printf("error creando z1. NO DEBE APARECER\n");
+	d=p;
+	iniciar_cerrojo(&d->c);
+
+	if ((fin=crear_semaforo("fin", 0))<0)
+		printf("error creando fin. NO DEBE APARECER\n");
+
+	for (i=1; i<=2; i++)
+		if (crear_proceso("memoria1")<0)
+			printf("Error creando memoria1\n");
+
+	esperar_semaforo(fin);
+	esperar_semaforo(fin);
+
+	if (d->cuenta==2*ITER)
+		printf("prueba_memoria: cuenta %d correcta\n", d->cuenta);
+	else
+		printf("prueba_memoria: cuenta %d incorrecta. NO DEBE APARECER\n",
+			d->cuenta);
+
+	if (desasociar_memoria(desc)<0)
+		printf("error desasociando z1. NO DEBE APARECER\n");
+
+	if (desasociar_memoria(desc)<0)
+		printf("error desasociando z1 por segunda vez. DEBE APARECER\n");
+
+	printf("prueba_memoria termina\n");
+	return 0;
+}
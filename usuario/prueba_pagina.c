@@ -0,0 +1,54 @@
+/*
+ * usuario/prueba_pagina.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la pgina de datos del kernel: el
+ * identificador y los tiempos que se leen de ella, que el reloj la
+ * actualiza y que no se puede modificar.
+ */
+
+#include "servicios.h"
+
+#define ESPERA 20	/* ticks que espera consultando la pgina */
+
+int main(){
+	pagina_datos p;
+	struct tiempos_ejec t;
+	void *dir;
+	int t0, t1;
+
+	printf("prueba_pagina comienza\n");
+
+	if (leer_pagina_datos(&p)<0) {
+		printf("prueba_pagina: no hay pgina de datos (modo de simulacin)\n");
+		return 0;
+	}
+
+	if (p.id_actual==obtener_id_pr())
+		printf("identificador de la pgina correcto. DEBE APARECER\n");
+
+	/* sin hacer llamadas al sistema el tiempo debe avanzar */
+	t0=tiempos_proceso(&t);
+	while ((t1=tiempos_proceso(0))-t0<ESPERA);
+	tiempos_proceso(&t);
+	if (t.usuario+t.sistema>=ESPERA)
+		printf("tiempo de UCP avanza sin llamadas. DEBE APARECER\n");
+
+	leer_pagina_datos(&p);
+	if (p.ticks>=t1 && p.cambios_contexto>0)
+		printf("reloj y cambios de contexto publicados. DEBE APARECER\n");
+
+	/* la pgina es de slo lectura: se produce una excepcin */
+	obtener_pagina_datos(&dir);
+	printf("prueba_pagina: escribe en la pgina. DEBE PRODUCIR EXCEPCION\n");
+	((pagina_datos *)dir)->ticks=0;
+
+	printf("prueba_pagina: pgina modificada. NO DEBE APARECER\n");
+	return 1;
+}
@@ -0,0 +1,68 @@
+/*
+ * usuario/prueba_parametros.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los parmetros del kernel: los lee,
+ * cambia en marcha los que lo admiten y comprueba que se respetan los
+ * lmites que fijan. El escenario de prueba arranca con el fichero de
+ * configuracin pruebas/entradas/prueba_parametros.conf.
+ *
+ */
+
+#include "servicios.h"
+
+int main(){
+	int n, i, rodaja, procesos;
+	char nombre[]="pmutex0";
+
+	printf("prueba_parametros comienza\n");
+
+	printf("tick %d rodaja %d buffer_terminal %d\n",
+		leer_parametro("tick"), leer_parametro("rodaja"),
+		leer_parametro("buffer_terminal"));
+	printf("mutex %d mutex_proceso %d procesos %d\n",
+		leer_parametro("mutex"), leer_parametro("mutex_proceso"),
+		leer_parametro("procesos"));
+
+	if (leer_parametro("noexiste")<0 && fijar_parametro("noexiste", 1)==-1)
+		printf("parametro inexistente rechazado. DEBE APARECER\n");
+	if (fijar_parametro("rodaja", 0)==-2)
+		printf("valor fuera de rango rechazado. DEBE APARECER\n");
+	if (fijar_parametro("mutex", 4)==-3 && fijar_parametro("tick", 50)==-3)
+		printf("parametros de arranque no modificables. DEBE APARECER\n");
+
+	/* la rodaja se cambia en marcha */
+	rodaja=leer_parametro("rodaja");
+	if (fijar_parametro("rodaja", 3)==0 && leer_parametro("rodaja")==3)
+		printf("rodaja cambiada en marcha. DEBE APARECER\n");
+	fijar_parametro("rodaja", rodaja);
+
+	/* cada proceso puede abrir mutex_proceso mutex */
+	n=leer_parametro("mutex_proceso");
+	for (i=0; i<n; i++) {
+		nombre[6]='0'+i;
+		if (crear_mutex(nombre, NO_RECURSIVO)<0)
+			printf("error creando mutex. NO DEBE APARECER\n");
+	}
+	nombre[6]='0'+n;
+	if (crear_mutex(nombre, NO_RECURSIVO)<0)
+		printf("limite de mutex por proceso del parametro. DEBE APARECER\n");
+	for (i=0; i<n; i++)
+		cerrar_mutex(i);
+
+	/* con procesos a 2 slo cabe un proceso ms */
+	procesos=leer_parametro("procesos");
+	fijar_parametro("procesos", 2);
+	if (crear_proceso("mudo")==0 && crear_proceso("mudo")<0)
+		printf("limite de procesos del parametro. DEBE APARECER\n");
+	fijar_parametro("procesos", procesos);
+
+	printf("prueba_parametros termina\n");
+	return 0;
+}
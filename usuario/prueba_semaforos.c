@@ -0,0 +1,59 @@
+/*
+ * usuario/prueba_semaforos.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de los semforos
+ *
+ */
+
+#include "servicios.h"
+
+int main(){
+	int desc, i;
+
+	printf("prueba_semaforos comienza\n");
+
+	if ((desc=crear_semaforo("s1", 0))<0)
+		printf("error creando s1. NO DEBE APARECER\n");
+
+	if (crear_semaforo("s1", 0)<0)
+		printf("error creando s1 por segunda vez. DEBE APARECER\n");
+
+	/* Probamos a usar un descriptor errneo */
+	if (senalar_semaforo(desc+1)<0)
+		printf("error en senalar_semaforo. DEBE APARECER\n");
+
+	/* semforo a 0 -> se bloqueara */
+	if (intentar_semaforo(desc)<0)
+		printf("intentar_semaforo con valor 0. DEBE APARECER\n");
+
+	for (i=1; i<=3; i++)
+		if (crear_proceso("semaforo1")<0)
+			printf("Error creando semaforo1\n");
+
+	printf("prueba_semaforos duerme 1 seg.: los procesos semaforo1 se bloquearn en s1\n");
+	dormir(1);
+
+	for (i=1; i<=3; i++) {
+		printf("prueba_semaforos seala s1: debe despertar un semaforo1 en orden de llegada\n");
+		if (senalar_semaforo(desc)<0)
+			printf("error en senalar_semaforo. NO DEBE APARECER\n");
+		dormir(1);
+	}
+
+	/* nadie espera: la seal se queda en el contador */
+	if (senalar_semaforo(desc)<0)
+		printf("error en senalar_semaforo. NO DEBE APARECER\n");
+
+	if (intentar_semaforo(desc)<0)
+		printf("error en intentar_semaforo. NO DEBE APARECER\n");
+
+	printf("prueba_semaforos termina\n");
+	return 0;
+}
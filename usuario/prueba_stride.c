@@ -0,0 +1,39 @@
+/*
+ * usuario/prueba_stride.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la planificacin stride: crea tres
+ * procesos stride1 con 100, 200 y 300 billetes, que heredan de l, y que
+ * deben recibir UCP en proporcin 1:2:3.
+ *
+ */
+
+#include "servicios.h"
+
+int main(){
+	int i;
+
+	printf("prueba_stride comienza\n");
+
+	if (fijar_planificacion(3)<0)
+		printf("poltica no vlida. DEBE APARECER\n");
+	fijar_planificacion(PLAN_STRIDE);
+
+	if (fijar_billetes(0)==100)
+		printf("billetes por defecto 100. DEBE APARECER\n");
+
+	for (i=1; i<=3; i++) {
+		fijar_billetes(i*100);
+		if (crear_proceso("stride1")<0)
+			printf("Error creando stride1\n");
+	}
+
+	printf("prueba_stride termina\n");
+	return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * usuario/prueba_temporizador.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que compara un bucle peridico basado en
+ * dormir_ticks, que acumula el tiempo de clculo de cada iteracin, con
+ * otros basados en dormir_hasta y en un temporizador peridico, que
+ * mantienen la frecuencia.
+ *
+ */
+
+#include "servicios.h"
+
+#define PERIODO 10	/* ticks */
+#define CALCULO 3	/* ticks de clculo por iteracin */
+#define ITER 10
+
+/* consume la UCP durante los ticks indicados */
+static void calcular(int ticks){
+	int fin=tiempos_proceso(0)+ticks;
+
+	while (tiempos_proceso(0)<fin);
+}
+
+int main(){
+	int i, t0, t, tmp, n;
+	evento ev;
+
+	printf("prueba_temporizador comienza\n");
+
+	/* dormir relativo: cada iteracin dura PERIODO+CALCULO ticks */
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITER; i++) {
+		calcular(CALCULO);
+		dormir_ticks(PERIODO);
+	}
+	printf("dormir_ticks: %d iteraciones en %d ticks (deriva)\n",
+		ITER, tiempos_proceso(0)-t0);
+
+	/* plazos absolutos: cada iteracin dura PERIODO ticks */
+	t0=t=tiempos_proceso(0);
+	for (i=0; i<ITER; i++) {
+		calcular(CALCULO);
+		t+=PERIODO;
+		dormir_hasta(t);
+	}
+	printf("dormir_hasta: %d iteraciones en %d ticks. DEBEN SER %d\n",
+		ITER, tiempos_proceso(0)-t0, ITER*PERIODO);
+
+	if (dormir_hasta(t0)==1)
+		printf("dormir_hasta con plazo pasado no bloquea. DEBE APARECER\n");
+
+	/* temporizador peridico */
+	if (crear_temporizador("tmp", 0)<0)
+		printf("error creando temporizador sin periodo. DEBE APARECER\n");
+
+	if ((tmp=crear_temporizador("tmp", PERIODO))<0)
+		printf("error creando temporizador. NO DEBE APARECER\n");
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITER; i++) {
+		calcular(CALCULO);
+		esperar_temporizador(tmp);
+	}
+	printf("temporizador: %d iteraciones en %d ticks. DEBEN SER %d\n",
+		ITER, tiempos_proceso(0)-t0, ITER*PERIODO);
+
+	/* si el proceso se retrasa no pierde la cuenta de vencimientos */
+	calcular(3*PERIODO);
+	n=esperar_temporizador(tmp);
+	printf("tras un retraso de %d periodos: %d vencimientos\n", 3, n);
+
+	/* el temporizador como evento de esperar_eventos */
+	ev.tipo=EV_TEMPORIZADOR;
+	ev.desc=tmp;
+	if (esperar_eventos(&ev, 1, SIN_PLAZO)==1 && ev.listo)
+		printf("temporizador vencido como evento. DEBE APARECER\n");
+	esperar_temporizador(tmp);
+
+	cerrar_temporizador(tmp);
+	printf("prueba_temporizador termina\n");
+	return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * usuario/rt_lento.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de prueba_edf: proceso de tiempo
+ * real con periodo de 50 ticks y presupuesto de 20 que cada 4 periodos se excede de su presupuesto.
+ *
+ */
+
+#include "servicios.h"
+
+#define PERIODO 50
+#define PRESUPUESTO 20
+#define TRABAJO 15	/* ticks de UCP de cada trabajo */
+#define ITER 12
+
+/* consume los ticks de UCP indicados */
+static void calcular(int ticks){
+	struct tiempos_ejec t;
+	int fin;
+
+	tiempos_proceso(&t);
+	fin=t.usuario+t.sistema+ticks;
+	do
+		tiempos_proceso(&t);
+	while (t.usuario+t.sistema<fin);
+}
+
+int main(){
+	int i, fallos=0;
+
+	if (fijar_tiempo_real(PERIODO, PRESUPUESTO)<0) {
+		printf("rt_lento: no admitido. NO DEBE APARECER\n");
+		return 1;
+	}
+
+	for (i=0; i<ITER; i++) {
+		/* cada 4 periodos necesita ms UCP de la reservada */
+		calcular((i%4==3) ? PRESUPUESTO+5 : TRABAJO);
+		fallos=esperar_periodo();
+	}
+
+	printf("rt_lento: %d plazos incumplidos en %d periodos. DEBEN SER %d\n",
+		fallos, ITER, ITER/4);
+	return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * usuario/rt_rapido.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de prueba_edf: proceso de tiempo
+ * real con periodo de 20 ticks y presupuesto de 5 que no debe incumplir plazos.
+ *
+ */
+
+#include "servicios.h"
+
+#define PERIODO 20
+#define PRESUPUESTO 5
+#define TRABAJO 4	/* ticks de UCP de cada trabajo */
+#define ITER 12
+
+/* consume los ticks de UCP indicados */
+static void calcular(int ticks){
+	struct tiempos_ejec t;
+	int fin;
+
+	tiempos_proceso(&t);
+	fin=t.usuario+t.sistema+ticks;
+	do
+		tiempos_proceso(&t);
+	while (t.usuario+t.sistema<fin);
+}
+
+int main(){
+	int i, fallos=0;
+
+	if (fijar_tiempo_real(PERIODO, PRESUPUESTO)<0) {
+		printf("rt_rapido: no admitido. NO DEBE APARECER\n");
+		return 1;
+	}
+
+	for (i=0; i<ITER; i++) {
+		calcular(TRABAJO);
+		fallos=esperar_periodo();
+	}
+
+	printf("rt_rapido: %d plazos incumplidos en %d periodos. DEBEN SER %d\n",
+		fallos, ITER, 0);
+	return 0;
+}
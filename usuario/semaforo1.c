@@ -0,0 +1,32 @@
+/*
+ * usuario/semaforo1.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de una prueba de los semforos
+ *
+ */
+
+#include "servicios.h"
+
+int main(){
+	int desc, id;
+
+	id=obtener_id_pr();
+	printf("semaforo1 (%d) comienza\n", id);
+
+	if ((desc=abrir_semaforo("s1"))<0)
+		printf("error abriendo s1. NO DEBE APARECER\n");
+
+	printf("semaforo1 (%d) espera en s1\n", id);
+	if (esperar_semaforo(desc)<0)
+		printf("error en esperar_semaforo. NO DEBE APARECER\n");
+
+	printf("semaforo1 (%d) despierta y termina\n", id);
+	return 0;
+}
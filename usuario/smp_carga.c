@@ -0,0 +1,38 @@
+/*
+ * usuario/smp_carga.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de bench_smp: hace una cantidad
+ * fija de clculo sin llamadas al sistema, imprime los ticks de UCP que
+ * ha consumido y lo seala en "smp_fin".
+ */
+
+#include "servicios.h"
+
+#define ITERACIONES 200000000
+
+int main(){
+	struct tiempos_ejec t;
+	volatile unsigned int x=1;
+	int fin, i;
+
+	if ((fin=abrir_semaforo("smp_fin"))<0) {
+		printf("smp_carga: error abriendo semforo\n");
+		return 1;
+	}
+
+	for (i=0; i<ITERACIONES; i++)
+		x=x*1103515245+12345;
+
+	tiempos_proceso(&t);
+	printf("smp_carga (%d): %d ticks de UCP\n", obtener_id_pr(),
+		t.usuario+t.sistema);
+	senalar_semaforo(fin);
+	return 0;
+}
@@ -0,0 +1,33 @@
+/*
+ * usuario/stride1.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de prueba_stride: consume UCP
+ * durante un tiempo fijo e imprime la que ha recibido.
+ *
+ */
+
+#include "servicios.h"
+
+#define DURACION 600	/* ticks de reloj que compite por la UCP */
+
+int main(){
+	struct tiempos_ejec t;
+	int id, t0;
+
+	id=obtener_id_pr();
+
+	t0=tiempos_proceso(0);
+	while (tiempos_proceso(0)<t0+DURACION);
+
+	tiempos_proceso(&t);
+	printf("stride1 (%d): %d billetes, %d ticks de UCP\n",
+		id, fijar_billetes(0), t.usuario+t.sistema);
+	return 0;
+}